@@ -0,0 +1,293 @@
+/**
+ * @file ArenaRBTree.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief A generic red black tree whose nodes live in one array and link by 32 bit indices.
+ *
+ * @section DESCRIPTION
+ * Holds the implementation of an ArenaRBTree data structure that can add items, delete them, check for containment and
+ * run a func on all of the items it contains, by order. Released nodes are reused before the arena grows.
+ */
+// ------------------------------ includes ------------------------------
+#include "ArenaRBTree.h"
+#include "RBTreeFixups.h"
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define NO_ITEMS (0)
+
+#define FAILURE (0)
+#define SUCCESS (1)
+
+#define EQUAL (0)
+
+#define NIL (0u)
+#define FIRST_NODE (1u)
+
+#define INITIAL_CAPACITY (16u)
+#define MAX_CAPACITY (UINT32_MAX)
+#define GROWTH_FACTOR (2u)
+
+// the accessors of RBTREE_DEFINE_FIXUPS. the sentinel node NIL is black.
+#define ARENA_PARENT(tree, node) ((tree)->nodes[node].parent)
+#define ARENA_SET_PARENT(tree, node, newParent) ((tree)->nodes[node].parent = (newParent))
+#define ARENA_LEFT(tree, node) ((tree)->nodes[node].left)
+#define ARENA_RIGHT(tree, node) ((tree)->nodes[node].right)
+#define ARENA_IS_RED(tree, node) ((tree)->nodes[node].color == RED)
+#define ARENA_COLOR(tree, node) ((tree)->nodes[node].color)
+#define ARENA_SET_COLOR(tree, node, newColor) ((tree)->nodes[node].color = (newColor))
+#define ARENA_ROTATED(tree, parent, child) ((void) 0)
+#define ARENA_UNLINKED(tree, parent) ((void) 0)
+// ------------------------------ functions -----------------------------
+
+/**
+ * constructs a new ArenaRBTree with the given CompareFunc.
+ * @param compFunc: a function two compare two variables.
+ * @param freeFunc: a function to free an item of the tree, NULL if the items are not freed by the tree.
+ * @return: the new tree, NULL on failure.
+ */
+ArenaRBTree *newArenaRBTree(CompareFunc compFunc, FreeFunc freeFunc)
+{
+    ArenaRBTree *tree = (ArenaRBTree *) malloc(sizeof(ArenaRBTree));
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+    ArenaNode *nodes = (ArenaNode *) malloc(INITIAL_CAPACITY * sizeof(ArenaNode));
+    if (nodes == NULL)
+    {
+        free(tree);
+        return NULL;
+    }
+    nodes[NIL] = (ArenaNode) {.parent = NIL, .left = NIL, .right = NIL, .color = BLACK, .data = NULL};
+    *tree = (ArenaRBTree) {.nodes = nodes, .root = NIL, .freeNodes = NIL, .used = FIRST_NODE,
+                           .capacity = INITIAL_CAPACITY, .compFunc = compFunc, .freeFunc = freeFunc,
+                           .size = NO_ITEMS};
+    return tree;
+}
+
+/**
+ * @brief Takes a node out of the arena, growing it if needed. Growing may move tree->nodes.
+ * @param tree The tree to allocate a node in.
+ * @return The index of the uninitialized node, NIL on failure.
+ */
+static uint32_t allocArenaNode(ArenaRBTree *tree)
+{
+    if (tree->freeNodes != NIL)
+    {
+        uint32_t index = tree->freeNodes;
+        tree->freeNodes = tree->nodes[index].right;
+        return index;
+    }
+    if (tree->used == tree->capacity)
+    {
+        if (tree->capacity == MAX_CAPACITY)
+        {
+            return NIL;
+        }
+        uint32_t capacity = tree->capacity > MAX_CAPACITY / GROWTH_FACTOR ? MAX_CAPACITY :
+                            tree->capacity * GROWTH_FACTOR;
+        ArenaNode *nodes = (ArenaNode *) realloc(tree->nodes, (size_t) capacity * sizeof(ArenaNode));
+        if (nodes == NULL)
+        {
+            return NIL;
+        }
+        tree->nodes = nodes;
+        tree->capacity = capacity;
+    }
+    return (tree->used)++;
+}
+
+/**
+ * @brief Puts a node back on the free list of the arena, without touching its data.
+ * @param tree The tree that holds the node.
+ * @param index The node to release.
+ */
+static void recycleArenaNode(ArenaRBTree *tree, uint32_t index)
+{
+    tree->nodes[index].data = NULL;
+    tree->nodes[index].right = tree->freeNodes;
+    tree->freeNodes = index;
+}
+
+// replaceNodeArena, rotateArena, fixInsertionArena, fixDeletionArena and removeNodeArena, on the ARENA_ accessors.
+RBTREE_DEFINE_FIXUPS(Arena, ArenaRBTree, uint32_t, NIL, ARENA)
+
+/**
+ * @brief Finds the node with the data matching the input
+ * @param tree The tree to check
+ * @param data The data to check a match for
+ * @return The index of the node matching data, NIL if not found
+ */
+static uint32_t findArenaNode(const ArenaRBTree *tree, const void *data)
+{
+    const ArenaNode *nodes = tree->nodes;
+    uint32_t cur = tree->root;
+    while (cur != NIL)
+    {
+        int compRes = tree->compFunc(data, nodes[cur].data);
+        if (compRes == EQUAL)
+        {
+            return cur;
+        }
+        cur = compRes < EQUAL ? nodes[cur].left : nodes[cur].right;
+    }
+    return NIL;
+}
+
+/**
+ * add an item to the tree
+ * @param tree: the tree to add an item to.
+ * @param data: item to add to the tree.
+ * @return: 0 on failure, other on success. (if the item is already in the tree - failure).
+ */
+int insertToArenaRBTree(ArenaRBTree *tree, void *data)
+{
+    if (tree == NULL || data == NULL)
+    {
+        return FAILURE;
+    }
+    uint32_t parent = NIL, cur = tree->root;
+    int compRes = EQUAL;
+    while (cur != NIL)
+    {
+        compRes = tree->compFunc(data, tree->nodes[cur].data);
+        if (compRes == EQUAL)
+        {
+            return FAILURE;
+        }
+        parent = cur;
+        cur = compRes < EQUAL ? tree->nodes[cur].left : tree->nodes[cur].right;
+    }
+    uint32_t node = allocArenaNode(tree);
+    if (node == NIL)
+    {
+        return FAILURE;
+    }
+    ArenaNode *nodes = tree->nodes;
+    nodes[node] = (ArenaNode) {.parent = parent, .left = NIL, .right = NIL, .color = RED, .data = data};
+    if (parent == NIL)
+    {
+        tree->root = node;
+    }
+    else if (compRes < EQUAL)
+    {
+        nodes[parent].left = node;
+    }
+    else
+    {
+        nodes[parent].right = node;
+    }
+    fixInsertionArena(tree, node);
+    nodes[tree->root].color = BLACK;
+    (tree->size)++;
+    return SUCCESS;
+}
+
+/**
+ * remove an item from the tree
+ * @param tree: the tree to remove an item from.
+ * @param data: item to remove from the tree.
+ * @return: 0 on failure, other on success. (if data is not in the tree - failure).
+ */
+int deleteFromArenaRBTree(ArenaRBTree *tree, void *data)
+{
+    if (tree == NULL)
+    {
+        return FAILURE;
+    }
+    uint32_t toDelete = findArenaNode(tree, data);
+    if (toDelete == NIL)
+    {
+        return FAILURE;
+    }
+    removeNodeArena(tree, toDelete);
+    if (tree->freeFunc != NULL)
+    {
+        (tree->freeFunc)(tree->nodes[toDelete].data);
+    }
+    recycleArenaNode(tree, toDelete);
+    (tree->size)--;
+    return SUCCESS;
+}
+
+/**
+ * check whether the tree contains this item.
+ * @param tree: the tree to check.
+ * @param data: item to check.
+ * @return: 0 if the item is not in the tree, other if it is.
+ */
+int ArenaRBTreeContains(const ArenaRBTree *tree, const void *data)
+{
+    if (tree == NULL)
+    {
+        return FAILURE;
+    }
+    return findArenaNode(tree, data) != NIL;
+}
+
+/**
+ * Activate a function on each item of the tree. the order is an ascending order. if one of the activations of the
+ * function returns 0, the process stops.
+ * @param tree: the tree with all the items.
+ * @param func: the function to activate on all items.
+ * @param args: more optional arguments to the function (may be null if the given function support it).
+ * @return: 0 on failure, other on success.
+ */
+int forEachArenaRBTree(const ArenaRBTree *tree, forEachFunc func, void *args)
+{
+    if (tree == NULL)
+    {
+        return FAILURE;
+    }
+    const ArenaNode *nodes = tree->nodes;
+    uint32_t cur = tree->root;
+    while (cur != NIL && nodes[cur].left != NIL)
+    {
+        cur = nodes[cur].left;
+    }
+    while (cur != NIL)
+    {
+        if (func(nodes[cur].data, args) == FAILURE)
+        {
+            return FAILURE;
+        }
+        if (nodes[cur].right != NIL)
+        {
+            cur = nodes[cur].right;
+            while (nodes[cur].left != NIL)
+            {
+                cur = nodes[cur].left;
+            }
+            continue;
+        }
+        uint32_t child = cur;
+        cur = nodes[cur].parent;
+        while (cur != NIL && nodes[cur].right == child)
+        {
+            child = cur;
+            cur = nodes[cur].parent;
+        }
+    }
+    return SUCCESS;
+}
+
+/**
+ * free all memory of the data structure.
+ * @param tree: pointer to the tree to free.
+ */
+void freeArenaRBTree(ArenaRBTree **tree)
+{
+    ArenaNode *nodes = (*tree)->nodes;
+    for (uint32_t i = FIRST_NODE; (*tree)->freeFunc != NULL && i < (*tree)->used; ++i)
+    {
+        if (nodes[i].data != NULL)
+        {
+            ((*tree)->freeFunc)(nodes[i].data);
+        }
+    }
+    free(nodes);
+    free(*tree);
+    *tree = NULL;
+}
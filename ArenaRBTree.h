@@ -0,0 +1,88 @@
+#ifndef RBTREE_ARENARBTREE_H
+#define RBTREE_ARENARBTREE_H
+
+#include "RBTree.h"
+#include <stdint.h>
+
+/*
+ * a node of an ArenaRBTree. nodes refer to each other by their index in the arena, index 0 is a black sentinel that
+ * stands for "no node". a node takes 24 bytes on 64 bit machines.
+ */
+typedef struct ArenaNode
+{
+	uint32_t parent, left, right;
+	Color color;
+	void *data;
+} ArenaNode;
+
+/**
+ * a red black tree whose nodes live in one growable array. it holds less than 2^32 items, and since the nodes hold
+ * no addresses of other nodes the array can be moved, copied or mapped as is.
+ * it is a standalone type made by its own constructor, not an RBTree or an option of newRBTreeWithOptions (an RBTree
+ * links its nodes by pointers, and its functions walk them as such): the functions of RBTree.h do not take it, and it
+ * has only the functions below (insert, delete, contains, forEach and free). it keeps no RBTreeOptions (no node pools,
+ * caches, prefixes, order statistics or augmentations), no iterators, ranges, bulk inserts, split, join or set
+ * operations. the rebalancing is the one of RBTree.c, from RBTreeFixups.h.
+ */
+typedef struct ArenaRBTree
+{
+	ArenaNode *nodes;
+	uint32_t root;
+	uint32_t freeNodes; // released nodes, chained through their right index.
+	uint32_t used; // amount of nodes of the arena ever handed out, the sentinel included.
+	uint32_t capacity;
+	CompareFunc compFunc;
+	FreeFunc freeFunc;
+	long unsigned size;
+} ArenaRBTree;
+
+/**
+ * constructs a new ArenaRBTree with the given CompareFunc.
+ * @param compFunc: a function two compare two variables.
+ * @param freeFunc: a function to free an item of the tree, NULL if the items are not freed by the tree.
+ * @return: the new tree, NULL on failure.
+ */
+ArenaRBTree *newArenaRBTree(CompareFunc compFunc, FreeFunc freeFunc);
+
+/**
+ * add an item to the tree
+ * @param tree: the tree to add an item to.
+ * @param data: item to add to the tree.
+ * @return: 0 on failure, other on success. (if the item is already in the tree - failure).
+ */
+int insertToArenaRBTree(ArenaRBTree *tree, void *data);
+
+/**
+ * remove an item from the tree
+ * @param tree: the tree to remove an item from.
+ * @param data: item to remove from the tree.
+ * @return: 0 on failure, other on success. (if data is not in the tree - failure).
+ */
+int deleteFromArenaRBTree(ArenaRBTree *tree, void *data);
+
+/**
+ * check whether the tree contains this item.
+ * @param tree: the tree to check.
+ * @param data: item to check.
+ * @return: 0 if the item is not in the tree, other if it is.
+ */
+int ArenaRBTreeContains(const ArenaRBTree *tree, const void *data);
+
+/**
+ * Activate a function on each item of the tree. the order is an ascending order. if one of the activations of the
+ * function returns 0, the process stops.
+ * @param tree: the tree with all the items.
+ * @param func: the function to activate on all items.
+ * @param args: more optional arguments to the function (may be null if the given function support it).
+ * @return: 0 on failure, other on success.
+ */
+int forEachArenaRBTree(const ArenaRBTree *tree, forEachFunc func, void *args);
+
+/**
+ * free all memory of the data structure.
+ * @param tree: pointer to the tree to free.
+ */
+void freeArenaRBTree(ArenaRBTree **tree);
+
+
+#endif //RBTREE_ARENARBTREE_H
@@ -0,0 +1,17 @@
+/**
+ * @file DoubleRBTree.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief A red black tree of double items with an inlined comparison.
+ *
+ * @section DESCRIPTION
+ * Instantiates RBTREE_DEFINE for double items, compared inline.
+ */
+// ------------------------------ includes ------------------------------
+#include "DoubleRBTree.h"
+// -------------------------- const definitions -------------------------
+#define COMPARE_DOUBLES(a, b) RBTREE_COMPARE_NUMBERS(*(a), *(b))
+// ------------------------------ functions -----------------------------
+RBTREE_DEFINE(doubleTree, double, COMPARE_DOUBLES)
@@ -0,0 +1,14 @@
+#ifndef RBTREE_DOUBLERBTREE_H
+#define RBTREE_DOUBLERBTREE_H
+
+#include "RBTreeTemplate.h"
+
+/*
+ * a tree of double items compared inline (see RBTREE_DECLARE): doubleTreeNew, doubleTreeCompareItems,
+ * doubleTreeInsert, doubleTreeDelete, doubleTreeContains, doubleTreeFind and doubleTreeLowerBound. the items are
+ * pointers to doubles, owned by the tree like the items of any RBTree. NaN items are not supported.
+ */
+RBTREE_DECLARE(doubleTree, double);
+
+
+#endif //RBTREE_DOUBLERBTREE_H
@@ -0,0 +1,425 @@
+/**
+ * @file ForkJoinPool.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief A work stealing thread pool for divide and conquer tasks.
+ *
+ * @section DESCRIPTION
+ * Holds the implementation of a ForkJoinPool. Each worker has a deque of forked tasks guarded by its own mutex, so
+ * workers only contend when one steals from another. Workers with nothing to do sleep until a task is queued.
+ */
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 200112L
+#include "ForkJoinPool.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+// -------------------------- const definitions -------------------------
+#define FAILURE (0)
+#define SUCCESS (1)
+
+#define NOT_DONE (0)
+#define DONE (1)
+
+#define INTERNAL (0)
+#define EXTERNAL (1)
+
+#define INITIAL_CAPACITY (16)
+#define GROWTH_FACTOR (2)
+// ------------------------------ structs -------------------------------
+/**
+ * A queued task. Jobs live on the stack of the thread that forked them until they are joined.
+ */
+typedef struct Job
+{
+    ForkJoinTask task;
+    void *args;
+    atomic_int done;
+    int external; // queued by a thread outside the pool, which waits on the condition of the pool.
+} Job;
+
+/**
+ * A worker thread and its deque. The owner pushes and takes jobs at the tail, thieves take them at the head.
+ */
+typedef struct Worker
+{
+    ForkJoinPool *pool;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    Job **jobs;
+    int head, tail, capacity;
+} Worker;
+
+struct ForkJoinPool
+{
+    Worker *workers;
+    int amount;
+    atomic_int queued; // jobs in all deques.
+    atomic_int sleeping; // workers waiting for jobs.
+    atomic_int shutdown;
+    atomic_uint nextWorker; // deque for the next job from outside the pool.
+    pthread_mutex_t lock;
+    pthread_cond_t hasJobs;
+    pthread_cond_t jobDone;
+};
+
+/**
+ * The arguments of a pair of tasks forked from outside the pool.
+ */
+typedef struct TaskPair
+{
+    ForkJoinPool *pool;
+    ForkJoinTask first, second;
+    void *firstArgs, *secondArgs;
+} TaskPair;
+// ------------------------------ functions -----------------------------
+
+/**
+ * The worker of the current thread, NULL for threads outside of any pool.
+ */
+static _Thread_local Worker *currentWorker = NULL;
+
+/**
+ * @brief Adds a job at the tail of a deque and wakes a sleeping worker.
+ * @param worker The owner of the deque.
+ * @param job The job to add.
+ * @return 1 on success, 0 if the deque can not grow.
+ */
+static int pushJob(Worker *worker, Job *job)
+{
+    pthread_mutex_lock(&worker->lock);
+    if (worker->tail == worker->capacity)
+    {
+        int live = worker->tail - worker->head;
+        if (worker->head > 0)
+        {
+            for (int i = 0; i < live; i++)
+            {
+                worker->jobs[i] = worker->jobs[worker->head + i];
+            }
+        }
+        else
+        {
+            Job **jobs = (Job **) realloc(worker->jobs, GROWTH_FACTOR * worker->capacity * sizeof(Job *));
+            if (jobs == NULL)
+            {
+                pthread_mutex_unlock(&worker->lock);
+                return FAILURE;
+            }
+            worker->jobs = jobs;
+            worker->capacity *= GROWTH_FACTOR;
+        }
+        worker->head = 0, worker->tail = live;
+    }
+    worker->jobs[(worker->tail)++] = job;
+    pthread_mutex_unlock(&worker->lock);
+    ForkJoinPool *pool = worker->pool;
+    atomic_fetch_add(&pool->queued, 1);
+    if (atomic_load(&pool->sleeping) > 0)
+    {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_signal(&pool->hasJobs);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return SUCCESS;
+}
+
+/**
+ * @brief Takes a job back from the tail of the deque of its owner, unless it was stolen.
+ * @param worker The owner of the deque.
+ * @param job The job pushed last by the owner.
+ * @return 1 if the job was taken back, 0 if it was stolen.
+ */
+static int takeBack(Worker *worker, const Job *job)
+{
+    int taken = FAILURE;
+    pthread_mutex_lock(&worker->lock);
+    if (worker->tail > worker->head && worker->jobs[worker->tail - 1] == job)
+    {
+        (worker->tail)--;
+        taken = SUCCESS;
+    }
+    pthread_mutex_unlock(&worker->lock);
+    if (taken)
+    {
+        atomic_fetch_sub(&worker->pool->queued, 1);
+    }
+    return taken;
+}
+
+/**
+ * @brief Takes the oldest job of a deque.
+ * @param worker The owner of the deque.
+ * @return The job, NULL if the deque is empty.
+ */
+static Job *stealJob(Worker *worker)
+{
+    Job *job = NULL;
+    pthread_mutex_lock(&worker->lock);
+    if (worker->tail > worker->head)
+    {
+        job = worker->jobs[(worker->head)++];
+    }
+    pthread_mutex_unlock(&worker->lock);
+    if (job != NULL)
+    {
+        atomic_fetch_sub(&worker->pool->queued, 1);
+    }
+    return job;
+}
+
+/**
+ * @brief Takes a job of any deque, starting from the own deque of thief.
+ * @param thief The worker looking for a job.
+ * @return The job, NULL if all the deques are empty.
+ */
+static Job *findJob(Worker *thief)
+{
+    ForkJoinPool *pool = thief->pool;
+    int start = (int) (thief - pool->workers);
+    for (int i = 0; i < pool->amount && atomic_load(&pool->queued) > 0; i++)
+    {
+        Job *job = stealJob(&pool->workers[(start + i) % pool->amount]);
+        if (job != NULL)
+        {
+            return job;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Runs a job and marks it as done, waking its waiter if it is outside the pool.
+ * @param pool The pool the job was queued on.
+ * @param job The job to run.
+ */
+static void runJob(ForkJoinPool *pool, Job *job)
+{
+    job->task(job->args);
+    if (job->external)
+    {
+        pthread_mutex_lock(&pool->lock);
+        atomic_store(&job->done, DONE);
+        pthread_cond_broadcast(&pool->jobDone);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    else
+    {
+        atomic_store(&job->done, DONE);
+    }
+}
+
+/**
+ * @brief The main loop of a worker thread: runs jobs until the pool shuts down, sleeping while there are none.
+ * @param args The worker.
+ * @return NULL.
+ */
+static void *workerLoop(void *args)
+{
+    Worker *worker = (Worker *) args;
+    ForkJoinPool *pool = worker->pool;
+    currentWorker = worker;
+    while (!atomic_load(&pool->shutdown))
+    {
+        Job *job = findJob(worker);
+        if (job != NULL)
+        {
+            runJob(pool, job);
+            continue;
+        }
+        pthread_mutex_lock(&pool->lock);
+        atomic_fetch_add(&pool->sleeping, 1);
+        if (atomic_load(&pool->queued) == 0 && !atomic_load(&pool->shutdown))
+        {
+            pthread_cond_wait(&pool->hasJobs, &pool->lock);
+        }
+        atomic_fetch_sub(&pool->sleeping, 1);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Wakes the workers of a pool, waits for them to exit and frees the pool.
+ * @param pool The pool to free.
+ * @param started The amount of workers whose threads were started.
+ */
+static void stopPool(ForkJoinPool *pool, int started)
+{
+    pthread_mutex_lock(&pool->lock);
+    atomic_store(&pool->shutdown, SUCCESS);
+    pthread_cond_broadcast(&pool->hasJobs);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+    for (int i = 0; i < pool->amount; i++)
+    {
+        pthread_mutex_destroy(&pool->workers[i].lock);
+        free(pool->workers[i].jobs);
+    }
+    pthread_cond_destroy(&pool->jobDone);
+    pthread_cond_destroy(&pool->hasJobs);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool);
+}
+
+/**
+ * constructs a new pool and starts its worker threads.
+ * @param workers: the amount of worker threads, 0 for one per online processor.
+ * @return: the new pool, NULL on failure.
+ */
+ForkJoinPool *newForkJoinPool(int workers)
+{
+    if (workers <= 0)
+    {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = processors > 0 ? (int) processors : 1;
+    }
+    ForkJoinPool *pool = (ForkJoinPool *) malloc(sizeof(ForkJoinPool));
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    pool->workers = (Worker *) calloc((size_t) workers, sizeof(Worker));
+    if (pool->workers == NULL)
+    {
+        free(pool);
+        return NULL;
+    }
+    pool->amount = workers;
+    atomic_init(&pool->queued, 0);
+    atomic_init(&pool->sleeping, 0);
+    atomic_init(&pool->shutdown, FAILURE);
+    atomic_init(&pool->nextWorker, 0);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->hasJobs, NULL);
+    pthread_cond_init(&pool->jobDone, NULL);
+    for (int i = 0; i < workers; i++)
+    {
+        Worker *worker = &pool->workers[i];
+        *worker = (Worker) {.pool = pool, .jobs = NULL, .head = 0, .tail = 0, .capacity = INITIAL_CAPACITY};
+        pthread_mutex_init(&worker->lock, NULL);
+        worker->jobs = (Job **) malloc(INITIAL_CAPACITY * sizeof(Job *));
+    }
+    for (int i = 0; i < workers; i++)
+    {
+        if (pool->workers[i].jobs == NULL || pthread_create(&pool->workers[i].thread, NULL, workerLoop,
+                                                            &pool->workers[i]) != 0)
+        {
+            stopPool(pool, i);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+/**
+ * @brief Runs a pair of tasks forked from outside the pool, on a worker of the pool.
+ * @param args The TaskPair.
+ */
+static void runTaskPair(void *args)
+{
+    TaskPair *pair = (TaskPair *) args;
+    forkJoin(pair->pool, pair->first, pair->firstArgs, pair->second, pair->secondArgs);
+}
+
+/**
+ * @brief Queues a pair of tasks from a thread outside the pool and waits for them.
+ * @return 1 on success, 0 if the pair could not be queued.
+ */
+static int forkJoinFromOutside(ForkJoinPool *pool, ForkJoinTask first, void *firstArgs, ForkJoinTask second,
+                               void *secondArgs)
+{
+    TaskPair pair = {.pool = pool, .first = first, .second = second, .firstArgs = firstArgs,
+                     .secondArgs = secondArgs};
+    Job job = {.task = runTaskPair, .args = &pair, .external = EXTERNAL};
+    atomic_init(&job.done, NOT_DONE);
+    unsigned index = atomic_fetch_add(&pool->nextWorker, 1) % (unsigned) pool->amount;
+    if (!pushJob(&pool->workers[index], &job))
+    {
+        return FAILURE;
+    }
+    pthread_mutex_lock(&pool->lock);
+    while (atomic_load(&job.done) == NOT_DONE)
+    {
+        pthread_cond_wait(&pool->jobDone, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return SUCCESS;
+}
+
+/**
+ * run two tasks in parallel and wait for both to finish. called from a task of the pool, the second task is offered
+ * to the other workers while the calling worker runs the first one, and while it waits for a stolen task it helps
+ * with the tasks of the others. called from another thread, the pair runs on the pool and the caller waits.
+ * if the pool is NULL, or a task can not be queued, the tasks run one after the other on the calling thread.
+ * @param pool: the pool to run the tasks on, may be NULL.
+ * @param first: the first task.
+ * @param firstArgs: the arguments of the first task.
+ * @param second: the second task.
+ * @param secondArgs: the arguments of the second task.
+ */
+void forkJoin(ForkJoinPool *pool, ForkJoinTask first, void *firstArgs, ForkJoinTask second, void *secondArgs)
+{
+    Worker *worker = currentWorker;
+    if (pool != NULL && (worker == NULL || worker->pool != pool))
+    {
+        if (forkJoinFromOutside(pool, first, firstArgs, second, secondArgs))
+        {
+            return;
+        }
+        pool = NULL;
+    }
+    Job job = {.task = second, .args = secondArgs, .external = INTERNAL};
+    atomic_init(&job.done, NOT_DONE);
+    if (pool == NULL || !pushJob(worker, &job))
+    {
+        first(firstArgs);
+        second(secondArgs);
+        return;
+    }
+    first(firstArgs);
+    if (takeBack(worker, &job))
+    {
+        second(secondArgs);
+        return;
+    }
+    while (atomic_load(&job.done) == NOT_DONE)
+    {
+        Job *other = findJob(worker);
+        if (other != NULL)
+        {
+            runJob(pool, other);
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+}
+
+/**
+ * @param pool: a pool, may be NULL.
+ * @return: the amount of worker threads of the pool, 0 for NULL.
+ */
+int forkJoinWorkers(const ForkJoinPool *pool)
+{
+    return pool != NULL ? pool->amount : 0;
+}
+
+/**
+ * stop the workers and free all memory of the pool. no task may be running on it.
+ * @param pool: pointer to the pool to free.
+ */
+void freeForkJoinPool(ForkJoinPool **pool)
+{
+    stopPool(*pool, (*pool)->amount);
+    *pool = NULL;
+}
@@ -0,0 +1,49 @@
+#ifndef RBTREE_FORKJOINPOOL_H
+#define RBTREE_FORKJOINPOOL_H
+
+/**
+ * a task to run on a pool.
+ * @args: pointer to the arguments of the task.
+ */
+typedef void (*ForkJoinTask)(void *args);
+
+/**
+ * a pool of worker threads. each worker keeps a deque of forked tasks: it works on the newest one itself, and idle
+ * workers steal the oldest ones (the biggest, for divide and conquer tasks) from the others.
+ */
+typedef struct ForkJoinPool ForkJoinPool;
+
+/**
+ * constructs a new pool and starts its worker threads.
+ * @param workers: the amount of worker threads, 0 for one per online processor.
+ * @return: the new pool, NULL on failure.
+ */
+ForkJoinPool *newForkJoinPool(int workers);
+
+/**
+ * run two tasks in parallel and wait for both to finish. called from a task of the pool, the second task is offered
+ * to the other workers while the calling worker runs the first one, and while it waits for a stolen task it helps
+ * with the tasks of the others. called from another thread, the pair runs on the pool and the caller waits.
+ * if the pool is NULL, or a task can not be queued, the tasks run one after the other on the calling thread.
+ * @param pool: the pool to run the tasks on, may be NULL.
+ * @param first: the first task.
+ * @param firstArgs: the arguments of the first task.
+ * @param second: the second task.
+ * @param secondArgs: the arguments of the second task.
+ */
+void forkJoin(ForkJoinPool *pool, ForkJoinTask first, void *firstArgs, ForkJoinTask second, void *secondArgs);
+
+/**
+ * @param pool: a pool, may be NULL.
+ * @return: the amount of worker threads of the pool, 0 for NULL.
+ */
+int forkJoinWorkers(const ForkJoinPool *pool);
+
+/**
+ * stop the workers and free all memory of the pool. no task may be running on it.
+ * @param pool: pointer to the pool to free.
+ */
+void freeForkJoinPool(ForkJoinPool **pool);
+
+
+#endif //RBTREE_FORKJOINPOOL_H
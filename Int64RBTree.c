@@ -0,0 +1,15 @@
+/**
+ * @file Int64RBTree.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief A red black tree of int64_t keys kept in its nodes.
+ *
+ * @section DESCRIPTION
+ * Instantiates RBTREE_DEFINE_KEYS for int64_t keys, compared inline.
+ */
+// ------------------------------ includes ------------------------------
+#include "Int64RBTree.h"
+// ------------------------------ functions -----------------------------
+RBTREE_DEFINE_KEYS(int64Tree, int64_t, RBTREE_COMPARE_NUMBERS)
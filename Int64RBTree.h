@@ -0,0 +1,16 @@
+#ifndef RBTREE_INT64RBTREE_H
+#define RBTREE_INT64RBTREE_H
+
+#include "RBTreeTemplate.h"
+#include <stdint.h>
+
+/*
+ * a tree of int64_t keys kept in the nodes in place of item pointers (see RBTREE_DECLARE_KEYS): int64TreeNew,
+ * int64TreeInsert, int64TreeDelete, int64TreeContains, int64TreeLowerBound, int64TreeIteratorKey, and int64TreeItem
+ * and int64TreeKey to use the trees with the functions of RBTree.h. the keys need 64 bit pointers.
+ * INT64_MIN is the key held by a NULL item: int64TreeInsert rejects it (returns 0), so a tree never holds it.
+ */
+RBTREE_DECLARE_KEYS(int64Tree, int64_t);
+
+
+#endif //RBTREE_INT64RBTREE_H
@@ -12,6 +12,10 @@
  */
 // ------------------------------ includes ------------------------------
 #include "RBTree.h"
+#include "RBTreeInternal.h"
+#include "RBTreeFixups.h"
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 // -------------------------- const definitions -------------------------
@@ -24,53 +28,547 @@
 #define LEFT (-1)
 #define EQUAL (0)
 #define RIGHT (1)
+
+#define EXCLUSIVE (0)
+#define INCLUSIVE (1)
+
+#define NO_SLAB_NODES (0)
+
+#define NOT_KEPT (0)
+
+#define COLOR_MASK ((uintptr_t) 1)
+
+#define FIELD_ALIGNMENT (8)
+
+// the accessors of RBTREE_DEFINE_FIXUPS.
+#define NODE_PARENT(tree, node) getParent(node)
+#define NODE_SET_PARENT(tree, node, parent) setParent(node, parent)
+#define NODE_LEFT(tree, node) ((node)->left)
+#define NODE_RIGHT(tree, node) ((node)->right)
+#define NODE_IS_RED(tree, node) ((node) != NULL && getColor(node) == RED)
+#define NODE_COLOR(tree, node) getColor(node)
+#define NODE_SET_COLOR(tree, node, color) setColor(node, color)
+#define NODE_ROTATED(tree, parent, child) refreshRotation(tree, parent, child)
+#define NODE_UNLINKED(tree, parent) refreshPath(tree, parent)
+
+// ------------------------------ structs -------------------------------
+/**
+ * A chunk of nodes allocated at once. The nodes are stored right after the header.
+ */
+typedef struct Slab
+{
+    struct Slab *next;
+    long unsigned used;
+} Slab;
+
+/**
+ * Holds the slabs of the trees that share it, and the released nodes the freed ones among them gave back. Released
+ * nodes are chained through their right pointer and have no data. Every tree carves its own slab and reuses its own
+ * released nodes, so the lock is taken only to add a slab, take the given back nodes, or change the users.
+ */
+typedef struct NodePool
+{
+    pthread_mutex_t lock;
+    Slab *slabs;
+    Node *freeNodes;
+    long unsigned slabNodes;
+    size_t nodeSize;
+    long unsigned users;
+} NodePool;
+
+/**
+ * Something the trees that share it own together, like the storage of their items. It is freed with the last of
+ * them.
+ */
+typedef struct OwnedResource
+{
+    void *resource;
+    FreeFunc freeFunc;
+    atomic_ulong users;
+} OwnedResource;
+
 // ------------------------------ functions -----------------------------
 
 /**
- * @brief Connects two nodes.
- * @param parent The node that is connected as the parent.
- * @param child The node that is connected as the child.
- * @param side The side of the parent to connect child to.
+ * @param node A node of a tree.
+ * @return The parent of node, NULL for the root.
+ */
+Node *getParent(const Node *node)
+{
+    return (Node *) (node->parentColor & ~COLOR_MASK);
+}
+
+/**
+ * @param node A node of a tree.
+ * @return The color of node.
  */
-void connectNodes(RBTree *tree, Node *parent, Node *child, int side);
+Color getColor(const Node *node)
+{
+    return (Color) (node->parentColor & COLOR_MASK);
+}
 
 /**
- * @param node The node whose children are to be checked
- * @return A pointer to node's child if the other child is NULL, NULL otherwise.
+ * @brief Sets the parent of a node, keeping its color.
+ * @param node The node to update.
+ * @param parent The new parent of node, may be NULL.
  */
-Node *getSingleChild(Node *node);
+static void setParent(Node *node, Node *parent)
+{
+    node->parentColor = (uintptr_t) parent | (node->parentColor & COLOR_MASK);
+}
 
 /**
- * @brief Solves recursively a problem of double black upon deletion.
- * @param tree The tree containing all of the nodes.
- * @param parent The parent of the node where the violation happened.
- * @param child The node that violates the RB rules.
- * @param childSide The side of the child as a child of parent.
+ * @brief Sets the color of a node, keeping its parent.
+ * @param node The node to update.
+ * @param color The new color of node.
  */
-void solveDB(RBTree *tree, Node **parentP, Node **childP, int childSide);
+static void setColor(Node *node, Color color)
+{
+    node->parentColor = (node->parentColor & ~COLOR_MASK) | (uintptr_t) color;
+}
 
 /**
  * @brief Frees the data of a node as well as the node itself.
  * @param tree The tree that contains the toFree to be freed.
  * @param toFree The node to be freed.
+ * @return The amount of items freed.
+ */
+long unsigned freeNode(RBTree *tree, Node *toFree);
+
+/**
+ * @brief Copies the augmentations a tree is constructed with.
+ * @param augmentations The augmentations.
+ * @param amount The amount of augmentations, at least 1.
+ * @return The copy, NULL on failure (or if an augmentation misses a function or a size).
  */
-void freeNode(RBTree *tree, Node *toFree);
+static RBTreeAugmentation *copyAugmentations(const RBTreeAugmentation *augmentations, int amount)
+{
+    if (augmentations == NULL)
+    {
+        return NULL;
+    }
+    for (int i = 0; i < amount; i++)
+    {
+        if (augmentations[i].summarySize == 0 || augmentations[i].summarizeFunc == NULL ||
+            augmentations[i].mergeFunc == NULL)
+        {
+            return NULL;
+        }
+    }
+    RBTreeAugmentation *copy = (RBTreeAugmentation *) malloc(amount * sizeof(RBTreeAugmentation));
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    memcpy(copy, augmentations, amount * sizeof(RBTreeAugmentation));
+    return copy;
+}
 
 /**
  * constructs a new RBTree with the given CompareFunc.
  * comp: a function two compare two variables.
  */
 RBTree *newRBTree(CompareFunc compFunc, FreeFunc freeFunc)
+{
+    return newRBTreeWithOptions(compFunc, freeFunc, NULL);
+}
+
+/**
+ * constructs a new RBTree with the given CompareFunc and optional features.
+ * @param compFunc: a function two compare two variables.
+ * @param freeFunc: a function to free an item of the tree.
+ * @param options: the features of the tree, NULL for the defaults of newRBTree.
+ * @return: the new tree, NULL on failure.
+ */
+RBTree *newRBTreeWithOptions(CompareFunc compFunc, FreeFunc freeFunc, const RBTreeOptions *options)
 {
     RBTree *tree = (RBTree *) malloc(sizeof(RBTree));
     if (tree == NULL)
     {
         return NULL;
     }
-    *tree = (RBTree) {.root = NULL, .compFunc = compFunc, .freeFunc = freeFunc, .size = NO_ITEMS};
+    *tree = (RBTree) {.root = NULL, .compFunc = compFunc, .freeFunc = freeFunc, .size = NO_ITEMS, .pool = NULL,
+                      .freeNodes = NULL, .slab = NULL, .nodeSize = sizeof(Node), .countOffset = NOT_KEPT, .cacheFunc = NULL,
+                      .cacheOffset = NOT_KEPT, .prefixFunc = NULL, .prefixOffset = NOT_KEPT, .augmentations = NULL,
+                      .augmentationsAmount = NO_ITEMS, .owned = NULL};
+    if (options != NULL && options->prefixFunc != NULL)
+    {
+        tree->prefixFunc = options->prefixFunc;
+        tree->prefixOffset = tree->nodeSize;
+        tree->nodeSize += sizeof(uint64_t);
+    }
+    if (options != NULL && options->orderStatistics)
+    {
+        tree->countOffset = tree->nodeSize;
+        tree->nodeSize += sizeof(long unsigned);
+    }
+    if (options != NULL && options->cacheFunc != NULL && options->cacheSize > 0)
+    {
+        tree->cacheFunc = options->cacheFunc;
+        tree->cacheOffset = tree->nodeSize;
+        tree->nodeSize += (options->cacheSize + FIELD_ALIGNMENT - 1) / FIELD_ALIGNMENT * FIELD_ALIGNMENT;
+    }
+    if (options != NULL && options->augmentationsAmount > NO_ITEMS)
+    {
+        tree->augmentations = copyAugmentations(options->augmentations, options->augmentationsAmount);
+        if (tree->augmentations == NULL)
+        {
+            free(tree);
+            return NULL;
+        }
+        tree->augmentationsAmount = options->augmentationsAmount;
+        for (int i = 0; i < tree->augmentationsAmount; i++)
+        {
+            RBTreeAugmentation *augmentation = &tree->augmentations[i];
+            augmentation->offset = tree->nodeSize;
+            tree->nodeSize += (augmentation->summarySize + FIELD_ALIGNMENT - 1) / FIELD_ALIGNMENT * FIELD_ALIGNMENT;
+        }
+    }
+    if (options != NULL && options->poolSlabNodes != NO_SLAB_NODES)
+    {
+        // a slab must have a size that fits in a size_t.
+        if (options->poolSlabNodes > (SIZE_MAX - sizeof(Slab)) / tree->nodeSize)
+        {
+            free(tree->augmentations);
+            free(tree);
+            return NULL;
+        }
+        tree->pool = (NodePool *) malloc(sizeof(NodePool));
+        if (tree->pool == NULL)
+        {
+            free(tree->augmentations);
+            free(tree);
+            return NULL;
+        }
+        *tree->pool = (NodePool) {.slabs = NULL, .freeNodes = NULL, .slabNodes = options->poolSlabNodes,
+                                  .nodeSize = tree->nodeSize, .users = 1};
+        if (pthread_mutex_init(&tree->pool->lock, NULL) != 0)
+        {
+            free(tree->pool);
+            free(tree->augmentations);
+            free(tree);
+            return NULL;
+        }
+    }
     return tree;
 }
 
+/**
+ * constructs an empty tree with the functions and features of another tree. the two trees share the node pool, so
+ * they can exchange nodes with joinRBTree. trees that share a pool can be changed and freed by different threads at
+ * once, but one tree must not be used by two threads at once.
+ * @param tree: the tree to copy the setup of.
+ * @return: the new tree, NULL on failure.
+ */
+RBTree *newRBTreeLike(const RBTree *tree)
+{
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+    RBTree *like = (RBTree *) malloc(sizeof(RBTree));
+    if (like == NULL)
+    {
+        return NULL;
+    }
+    *like = *tree;
+    like->root = NULL;
+    like->size = NO_ITEMS;
+    like->freeNodes = NULL;
+    like->slab = NULL;
+    if (tree->augmentationsAmount > NO_ITEMS)
+    {
+        like->augmentations = copyAugmentations(tree->augmentations, tree->augmentationsAmount);
+        if (like->augmentations == NULL)
+        {
+            free(like);
+            return NULL;
+        }
+    }
+    if (like->pool != NULL)
+    {
+        pthread_mutex_lock(&like->pool->lock);
+        (like->pool->users)++;
+        pthread_mutex_unlock(&like->pool->lock);
+    }
+    if (like->owned != NULL)
+    {
+        atomic_fetch_add(&like->owned->users, 1);
+    }
+    return like;
+}
+
+/**
+ * give a tree a resource to free after its items, like an arena that stores them. the trees made like the tree share
+ * the resource, and it is freed with the last of them.
+ * @param tree: a tree that owns nothing yet.
+ * @param resource: the resource.
+ * @param freeResource: a function to free the resource.
+ * @return: 0 on failure, other on success. (if the tree already owns a resource - failure, and the new resource stays
+ * owned by the caller).
+ */
+int ownRBTreeResource(RBTree *tree, void *resource, FreeFunc freeResource)
+{
+    if (tree == NULL || resource == NULL || freeResource == NULL || tree->owned != NULL)
+    {
+        return FAILURE;
+    }
+    tree->owned = (OwnedResource *) malloc(sizeof(OwnedResource));
+    if (tree->owned == NULL)
+    {
+        return FAILURE;
+    }
+    tree->owned->resource = resource;
+    tree->owned->freeFunc = freeResource;
+    atomic_init(&tree->owned->users, 1);
+    return SUCCESS;
+}
+
+/**
+ * @param tree: a tree.
+ * @return: the resource the tree owns, NULL if it owns none.
+ */
+void *RBTreeResource(const RBTree *tree)
+{
+    return tree == NULL || tree->owned == NULL ? NULL : tree->owned->resource;
+}
+
+/**
+ * @param tree A tree.
+ * @param other Another tree.
+ * @return 1 if the nodes of the trees keep the same summaries in the same places.
+ */
+static int sameAugmentations(const RBTree *tree, const RBTree *other)
+{
+    if (tree->augmentationsAmount != other->augmentationsAmount)
+    {
+        return FAILURE;
+    }
+    for (int i = 0; i < tree->augmentationsAmount; i++)
+    {
+        const RBTreeAugmentation *first = &tree->augmentations[i], *second = &other->augmentations[i];
+        if (first->summarySize != second->summarySize || first->summarizeFunc != second->summarizeFunc ||
+            first->mergeFunc != second->mergeFunc || first->offset != second->offset)
+        {
+            return FAILURE;
+        }
+    }
+    return SUCCESS;
+}
+
+/**
+ * @param tree A tree.
+ * @param other Another tree.
+ * @return 1 if nodes can move between the trees: they order and free items alike, allocate the same nodes from
+ * the same place and own the same resource.
+ */
+static int canShareNodes(const RBTree *tree, const RBTree *other)
+{
+    return tree->compFunc == other->compFunc && tree->freeFunc == other->freeFunc && tree->pool == other->pool &&
+           tree->owned == other->owned &&
+           tree->nodeSize == other->nodeSize && tree->countOffset == other->countOffset &&
+           tree->cacheFunc == other->cacheFunc && tree->cacheOffset == other->cacheOffset &&
+           tree->prefixFunc == other->prefixFunc && tree->prefixOffset == other->prefixOffset &&
+           sameAugmentations(tree, other);
+}
+
+/**
+ * @param pool A node pool.
+ * @param slab A slab of pool.
+ * @param index The place of a node in slab.
+ * @return The node stored at index in slab.
+ */
+static Node *slabNode(const NodePool *pool, Slab *slab, long unsigned index)
+{
+    return (Node *) ((char *) (slab + 1) + index * pool->nodeSize);
+}
+
+/**
+ * @brief Allocates a node for tree, from its pool if it has one. The released nodes and the slab of tree come first,
+ * and only then the pool is locked, to take the nodes freed trees gave back or a new slab.
+ * @param tree The tree the node is allocated for.
+ * @return The uninitialized node, NULL on failure.
+ */
+static Node *allocNode(RBTree *tree)
+{
+    NodePool *pool = tree->pool;
+    if (pool == NULL)
+    {
+        return (Node *) malloc(tree->nodeSize);
+    }
+    if (tree->freeNodes == NULL && (tree->slab == NULL || tree->slab->used == pool->slabNodes))
+    {
+        pthread_mutex_lock(&pool->lock);
+        tree->freeNodes = pool->freeNodes;
+        pool->freeNodes = NULL;
+        pthread_mutex_unlock(&pool->lock);
+    }
+    if (tree->freeNodes != NULL)
+    {
+        Node *node = tree->freeNodes;
+        tree->freeNodes = node->right;
+        return node;
+    }
+    if (tree->slab == NULL || tree->slab->used == pool->slabNodes)
+    {
+        Slab *slab = (Slab *) malloc(sizeof(Slab) + pool->slabNodes * pool->nodeSize);
+        if (slab == NULL)
+        {
+            return NULL;
+        }
+        slab->used = NO_ITEMS;
+        pthread_mutex_lock(&pool->lock);
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        pthread_mutex_unlock(&pool->lock);
+        tree->slab = slab;
+    }
+    return slabNode(pool, tree->slab, (tree->slab->used)++);
+}
+
+/**
+ * @brief Gives back the memory of a node allocated by allocNode, without touching its data. A pool node is kept by
+ * tree for its next allocations.
+ * @param tree The tree the node was allocated for.
+ * @param node The node to release.
+ */
+static void recycleNode(RBTree *tree, Node *node)
+{
+    if (tree->pool == NULL)
+    {
+        free(node);
+        return;
+    }
+    node->data = NULL;
+    node->right = tree->freeNodes;
+    tree->freeNodes = node;
+}
+
+/**
+ * @brief Gives the released nodes of tree to its pool, for the other trees that share it, and leaves the pool.
+ * @param tree A tree that is freed, after its items are.
+ * @return 1 if tree was the last user of the pool.
+ */
+static int leavePool(RBTree *tree)
+{
+    NodePool *pool = tree->pool;
+    Node *last = tree->freeNodes;
+    while (last != NULL && last->right != NULL)
+    {
+        last = last->right;
+    }
+    pthread_mutex_lock(&pool->lock);
+    if (last != NULL)
+    {
+        last->right = pool->freeNodes;
+        pool->freeNodes = tree->freeNodes;
+    }
+    tree->freeNodes = NULL;
+    int isLast = --(pool->users) == NO_ITEMS;
+    pthread_mutex_unlock(&pool->lock);
+    return isLast;
+}
+
+/**
+ * @brief Frees an item of a tree, unless the tree does not free its items.
+ * @param tree The tree that held the item.
+ * @param data The item to free.
+ */
+static void freeItem(const RBTree *tree, void *data)
+{
+    if (tree->freeFunc != NULL)
+    {
+        (tree->freeFunc)(data);
+    }
+}
+
+/**
+ * @brief Frees the data of all the nodes in the pool of tree, and then the pool itself. The slabs are scanned in
+ * memory order instead of walking the tree, and not at all if the tree does not free its items.
+ * @param tree The tree whose pool is to be freed.
+ */
+static void freePool(RBTree *tree)
+{
+    NodePool *pool = tree->pool;
+    Slab *slab = pool->slabs;
+    while (slab != NULL)
+    {
+        Slab *next = slab->next;
+        for (long unsigned i = NO_ITEMS; tree->freeFunc != NULL && i < slab->used; ++i)
+        {
+            Node *node = slabNode(pool, slab, i);
+            if (node->data != NULL)
+            {
+                (tree->freeFunc)(node->data);
+            }
+        }
+        free(slab);
+        slab = next;
+    }
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+    tree->pool = NULL;
+}
+
+/**
+ * @brief Computes the cache and the prefix of the item of a node, if the tree keeps them.
+ * @param tree The tree the node belongs to.
+ * @param node A node holding its item.
+ */
+static void fillCache(const RBTree *tree, Node *node)
+{
+    if (tree->cacheFunc != NULL)
+    {
+        tree->cacheFunc(node->data, (char *) node + tree->cacheOffset);
+    }
+    if (tree->prefixFunc != NULL)
+    {
+        *(uint64_t *) ((char *) node + tree->prefixOffset) = tree->prefixFunc(node->data);
+    }
+}
+
+/**
+ * @param tree A tree.
+ * @param key An item or a key to search for.
+ * @return The prefix of key, 0 if the tree keeps no prefixes.
+ */
+static uint64_t keyPrefix(const RBTree *tree, const void *key)
+{
+    return tree->prefixFunc != NULL ? tree->prefixFunc(key) : 0;
+}
+
+/**
+ * @param tree A tree.
+ * @param node A node of tree.
+ * @return The prefix kept in node, 0 if the tree keeps no prefixes.
+ */
+static uint64_t nodePrefix(const RBTree *tree, const Node *node)
+{
+    return tree->prefixFunc != NULL ? *(const uint64_t *) ((const char *) node + tree->prefixOffset) : 0;
+}
+
+/**
+ * @brief Compares a key with the item of a node. If the tree keeps prefixes, the prefix in the node is compared
+ * first, and the CompareFunc is called (and the item read) only if the prefixes are equal.
+ * @param tree The tree of the node.
+ * @param key The key to compare.
+ * @param prefix The prefix of key, from keyPrefix.
+ * @param node A node of tree.
+ * @return Like the CompareFunc of tree for key and the item of node.
+ */
+static int compareToNode(const RBTree *tree, const void *key, uint64_t prefix, const Node *node)
+{
+    if (tree->prefixFunc != NULL)
+    {
+        uint64_t otherPrefix = nodePrefix(tree, node);
+        if (prefix != otherPrefix)
+        {
+            return prefix < otherPrefix ? LEFT : RIGHT;
+        }
+    }
+    return tree->compFunc(key, node->data);
+}
+
 /**
  * @brief Connects node as parent's child
  * @param node The node to insert (as a child)
@@ -81,7 +579,7 @@ void connectNode(RBTree *tree, Node *node, Node *parent, int side)
 {
     if (node != NULL)
     {
-        node->parent = parent;
+        setParent(node, parent);
     }
     if (parent == NULL)
     {
@@ -98,604 +596,1549 @@ void connectNode(RBTree *tree, Node *node, Node *parent, int side)
 }
 
 /**
- * @param child The node to check whether it's right child or left
- * @return 0 if it has no parent, -1 if it is a left child, 1 if it is a right child
+ * @param tree A tree that keeps sub-tree sizes.
+ * @param node A node of tree, or NULL for an empty sub-tree.
+ * @return The amount of items in the sub-tree of node.
+ */
+long unsigned RBTreeSubtreeCount(const RBTree *tree, const Node *node)
+{
+    if (node == NULL)
+    {
+        return NO_ITEMS;
+    }
+    return *(const long unsigned *) ((const char *) node + tree->countOffset);
+}
+
+/**
+ * @param tree The tree the node belongs to.
+ * @param node A node of tree.
+ * @return The cache of the item of node, NULL if the tree keeps none.
+ */
+const void *RBTreeItemCache(const RBTree *tree, const Node *node)
+{
+    return tree->cacheFunc != NULL ? (const char *) node + tree->cacheOffset : NULL;
+}
+
+/**
+ * @param augmentation An augmentation of a tree.
+ * @param node A node of the tree.
+ * @return The summary of the sub-tree of node for augmentation.
+ */
+static void *subtreeSummary(const RBTreeAugmentation *augmentation, const Node *node)
+{
+    return (char *) node + augmentation->offset;
+}
+
+/**
+ * @param tree A tree.
+ * @return 1 if the nodes of tree keep fields computed from their sub-trees, 0 otherwise.
+ */
+static int isAugmented(const RBTree *tree)
+{
+    return tree->countOffset != NOT_KEPT || tree->augmentationsAmount > NO_ITEMS;
+}
+
+/**
+ * @brief Recomputes the fields a node keeps about its sub-tree from those of its children.
+ * @param tree The tree containing node.
+ * @param node The node to update.
+ */
+static void refreshNode(const RBTree *tree, Node *node)
+{
+    if (tree->countOffset != NOT_KEPT)
+    {
+        *(long unsigned *) ((char *) node + tree->countOffset) =
+                RBTreeSubtreeCount(tree, node->left) + RBTreeSubtreeCount(tree, node->right) + 1;
+    }
+    for (int i = 0; i < tree->augmentationsAmount; i++)
+    {
+        const RBTreeAugmentation *augmentation = &tree->augmentations[i];
+        void *summary = subtreeSummary(augmentation, node);
+        augmentation->summarizeFunc(summary, node->data, RBTreeItemCache(tree, node));
+        if (node->left != NULL)
+        {
+            augmentation->mergeFunc(summary, subtreeSummary(augmentation, node->left), summary);
+        }
+        if (node->right != NULL)
+        {
+            augmentation->mergeFunc(summary, summary, subtreeSummary(augmentation, node->right));
+        }
+    }
+}
+
+/**
+ * @brief Recomputes the fields kept about sub-trees for a node and all of its ancestors.
+ * @param tree The tree containing node.
+ * @param node The lowest node to update, may be NULL.
+ */
+static void refreshPath(const RBTree *tree, Node *node)
+{
+    if (!isAugmented(tree))
+    {
+        return;
+    }
+    for (; node != NULL; node = getParent(node))
+    {
+        refreshNode(tree, node);
+    }
+}
+
+/**
+ * @brief Recomputes the summaries of the two nodes of a rotation, if the tree keeps any.
+ * @param tree The tree of the nodes.
+ * @param parent The old root of the rotated sub-tree, now the child of child.
+ * @param child The new root of the rotated sub-tree.
+ */
+static void refreshRotation(const RBTree *tree, Node *parent, Node *child)
+{
+    if (isAugmented(tree))
+    {
+        refreshNode(tree, parent);
+        refreshNode(tree, child);
+    }
+}
+
+// replaceNode, rotate, fixInsertion, fixDeletion and removeNode, on the NODE_ accessors.
+RBTREE_DEFINE_FIXUPS(, RBTree, Node *, NULL, NODE)
+
+/**
+ * @brief Inserts a new node to a RBtree in the right position, searching from the given node down.
+ * @param tree The tree to insert the node to.
+ * @param from The root of the sub-tree whose range holds the data of newNode, NULL if the tree is empty.
+ * @param newNode The node to insert.
+ * @param prefix The prefix of the data of newNode, from keyPrefix.
+ * @return 1 upon success, 0 if there is a node with the same data as newNode's already in tree.
+ */
+int insertNode(RBTree *tree, Node *from, Node *newNode, uint64_t prefix)
+{
+    Node *found, *parent;
+    int side;
+    RBTREE_DESCEND(from, cur, compareToNode(tree, newNode->data, prefix, cur), found, parent, side);
+    if (found != NULL)
+    {
+        return FAILURE;
+    }
+    connectNode(tree, newNode, parent, side);
+    return SUCCESS;
+}
+
+/**
+ * @brief Fills what the tree keeps for a node that was just linked as a red leaf, rebalances the tree and counts the
+ * node.
+ * @param tree The tree the node was linked into.
+ * @param newNode The new node.
+ */
+static void balanceNewNode(RBTree *tree, Node *newNode)
+{
+    fillCache(tree, newNode);
+    refreshPath(tree, newNode);
+    fixInsertion(tree, newNode);
+    setColor(tree->root, BLACK);
+    (tree->size)++;
+}
+
+/**
+ * @brief Adds a node with an item at a place found by RBTREE_DESCEND, and rebalances the tree.
+ * @param tree The tree to add the item to.
+ * @param data The item, which must not be in the tree.
+ * @param parent The parent of the new node, NULL if the tree is empty.
+ * @param side The side of parent to link the new node at.
+ * @return The new node, NULL if its allocation failed.
+ */
+Node *RBTreeAddNode(RBTree *tree, void *data, Node *parent, int side)
+{
+    Node *newNode = allocNode(tree);
+    if (newNode == NULL)
+    {
+        return NULL;
+    }
+    *newNode = (Node) {.parentColor = (uintptr_t) RED, .right = NULL, .left = NULL, .data = data};
+    connectNode(tree, newNode, parent, side);
+    balanceNewNode(tree, newNode);
+    return newNode;
+}
+
+/**
+ * add an item to the tree
+ * @param tree: the tree to add an item to.
+ * @param data: item to add to the tree.
+ * @return: 0 on failure, other on success. (if the item is already in the tree - failure).
+ */
+int insertToRBTree(RBTree *tree, void *data)
+{
+    if (tree == NULL)
+    {
+        return FAILURE;
+    }
+    if (data == NULL)
+    {
+        return FAILURE;
+    }
+    Node *found, *parent;
+    int side;
+    uint64_t prefix = keyPrefix(tree, data);
+    RBTREE_DESCEND(tree->root, cur, compareToNode(tree, data, prefix, cur), found, parent, side);
+    if (found != NULL)
+    {
+        return FAILURE;
+    }
+    return RBTreeAddNode(tree, data, parent, side) != NULL;
+}
+
+/**
+ * @brief Gives back the memory of all the nodes of a sub-tree, without touching their data.
+ * @param tree The tree the nodes were allocated for.
+ * @param node The root of the sub-tree.
+ */
+static void recycleSubtree(RBTree *tree, Node *node)
+{
+    if (node == NULL)
+    {
+        return;
+    }
+    recycleSubtree(tree, node->left);
+    recycleSubtree(tree, node->right);
+    recycleNode(tree, node);
+}
+
+/**
+ * @brief Builds a perfectly balanced sub-tree out of sorted items. The nodes at redDepth are red, all others black.
+ * @param tree The tree the nodes are allocated for.
+ * @param items The sorted items of the sub-tree.
+ * @param amount The amount of items, at least 1.
+ * @param depth The depth of the root of the sub-tree.
+ * @param redDepth The depth of the red nodes.
+ * @return The root of the sub-tree, NULL on failure (nothing stays allocated).
+ */
+static Node *buildSubtree(RBTree *tree, void *const *items, long unsigned amount, int depth, int redDepth)
+{
+    long unsigned mid = amount / 2;
+    Node *node = allocNode(tree);
+    if (node == NULL)
+    {
+        return NULL;
+    }
+    Color color = depth == redDepth ? RED : BLACK;
+    *node = (Node) {.parentColor = (uintptr_t) color, .left = NULL, .right = NULL, .data = items[mid]};
+    fillCache(tree, node);
+    if (mid > NO_ITEMS)
+    {
+        node->left = buildSubtree(tree, items, mid, depth + 1, redDepth);
+        if (node->left == NULL)
+        {
+            recycleNode(tree, node);
+            return NULL;
+        }
+        setParent(node->left, node);
+    }
+    if (amount - mid - 1 > NO_ITEMS)
+    {
+        node->right = buildSubtree(tree, items + mid + 1, amount - mid - 1, depth + 1, redDepth);
+        if (node->right == NULL)
+        {
+            recycleSubtree(tree, node->left);
+            recycleNode(tree, node);
+            return NULL;
+        }
+        setParent(node->right, node);
+    }
+    refreshNode(tree, node);
+    return node;
+}
+
+/**
+ * @brief Makes an empty tree hold the given items.
+ * @param tree An empty tree.
+ * @param items The items, strictly ascending.
+ * @param amount The amount of items.
+ * @return 1 upon success, 0 if an allocation failed (the tree stays empty).
+ */
+static int buildTree(RBTree *tree, void *const *items, long unsigned amount)
+{
+    if (amount == NO_ITEMS)
+    {
+        return SUCCESS;
+    }
+    // all the leaves are on the two deepest levels, so coloring the deepest one red balances the black heights.
+    int maxDepth = 0;
+    for (long unsigned rest = amount; rest > 1; rest /= 2)
+    {
+        maxDepth++;
+    }
+    Node *root = buildSubtree(tree, items, amount, 0, maxDepth > 0 ? maxDepth : -1);
+    if (root == NULL)
+    {
+        return FAILURE;
+    }
+    tree->root = root;
+    tree->size = amount;
+    return SUCCESS;
+}
+
+/**
+ * fill an empty tree with sorted items in linear time, without rebalancing.
+ * @param tree: an empty tree.
+ * @param items: the items, in ascending order of the CompareFunc of the tree and without duplicates.
+ * @param amount: the amount of items.
+ * @return: 0 on failure, other on success. (if the tree is not empty or the items are not strictly ascending -
+ * failure, and the tree is left empty).
+ */
+int fillRBTreeFromSorted(RBTree *tree, void *const *items, long unsigned amount)
+{
+    if (tree == NULL || tree->root != NULL || (items == NULL && amount > NO_ITEMS))
+    {
+        return FAILURE;
+    }
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        if (items[i] == NULL || (i > 0 && tree->compFunc(items[i - 1], items[i]) >= EQUAL))
+        {
+            return FAILURE;
+        }
+    }
+    return buildTree(tree, items, amount);
+}
+
+/**
+ * @brief Sorts items with a stable merge sort.
+ * @param items The items to sort.
+ * @param buffer Room for amount items.
+ * @param amount The amount of items.
+ * @param compFunc The order of the items.
+ */
+static void sortItems(void **items, void **buffer, long unsigned amount, CompareFunc compFunc)
+{
+    if (amount < 2)
+    {
+        return;
+    }
+    long unsigned half = amount / 2;
+    sortItems(items, buffer, half, compFunc);
+    sortItems(items + half, buffer, amount - half, compFunc);
+    if (compFunc(items[half - 1], items[half]) < EQUAL)
+    {
+        return;
+    }
+    memcpy(buffer, items, half * sizeof(void *));
+    long unsigned left = 0, right = half, out = 0;
+    while (left < half && right < amount)
+    {
+        items[out++] = compFunc(items[right], buffer[left]) < EQUAL ? items[right++] : buffer[left++];
+    }
+    while (left < half)
+    {
+        items[out++] = buffer[left++];
+    }
+}
+
+/**
+ * @brief Moves the items that are not marked as kept to the end, keeping the order of both groups.
+ * @param items The items.
+ * @param buffer Room for amount items.
+ * @param kept For every item, whether it stays at the front.
+ * @param amount The amount of items.
+ * @return The amount of kept items.
+ */
+static long unsigned moveRejectedToEnd(void **items, void **buffer, const char *kept, long unsigned amount)
+{
+    long unsigned front = 0, rejected = 0;
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        if (kept[i])
+        {
+            items[front++] = items[i];
+        }
+        else
+        {
+            buffer[rejected++] = items[i];
+        }
+    }
+    memcpy(items + front, buffer, rejected * sizeof(void *));
+    return front;
+}
+
+/**
+ * @brief Inserts a node whose data is greater than the data of finger. The search climbs up from finger only until
+ * the range of the sub-tree holds the new data, so consecutive ascending inserts skip most of the descent.
+ * @param tree The tree to insert the node to.
+ * @param finger A node of the tree holding smaller data, NULL to search from the root.
+ * @param newNode The node to insert.
+ * @return 1 upon success, 0 if there is a node with the same data as newNode's already in tree.
+ */
+static int insertAfterFinger(RBTree *tree, Node *finger, Node *newNode)
+{
+    Node *from = finger != NULL ? finger : tree->root;
+    Node *parent;
+    uint64_t prefix = keyPrefix(tree, newNode->data);
+    while ((parent = getParent(from)) != NULL)
+    {
+        if (from == parent->left && compareToNode(tree, newNode->data, prefix, parent) < EQUAL)
+        {
+            break;
+        }
+        from = parent;
+    }
+    return insertNode(tree, from, newNode, prefix);
+}
+
+/**
+ * add a batch of items to the tree. the batch is sorted and merged in ascending order, each insertion searching from
+ * the previous one instead of from the root.
+ * @param tree: the tree to add the items to.
+ * @param items: the items to add. they are reordered: the first (new size - old size) of them are the inserted
+ * items in ascending order, and the rest are the items that were already in the tree or repeated in the batch, which
+ * stay owned by the caller.
+ * @param amount: the amount of items.
+ * @return: 0 on failure, other on success. (if an item is NULL or an allocation fails - failure, and the tree is not
+ * changed).
+ */
+int insertManyToRBTree(RBTree *tree, void **items, long unsigned amount)
+{
+    if (tree == NULL || (items == NULL && amount > NO_ITEMS))
+    {
+        return FAILURE;
+    }
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        if (items[i] == NULL)
+        {
+            return FAILURE;
+        }
+    }
+    if (amount == NO_ITEMS)
+    {
+        return SUCCESS;
+    }
+    void **buffer = (void **) malloc(amount * sizeof(void *));
+    char *kept = (char *) malloc(amount);
+    if (buffer == NULL || kept == NULL)
+    {
+        free(buffer);
+        free(kept);
+        return FAILURE;
+    }
+    sortItems(items, buffer, amount, tree->compFunc);
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        kept[i] = (char) (i == 0 || tree->compFunc(items[i - 1], items[i]) != EQUAL);
+    }
+    long unsigned unique = moveRejectedToEnd(items, buffer, kept, amount);
+    int result = SUCCESS;
+    if (tree->root == NULL)
+    {
+        result = buildTree(tree, items, unique);
+    }
+    else
+    {
+        Node *spare = NULL;
+        for (long unsigned i = 0; i < unique; ++i)
+        {
+            Node *node = allocNode(tree);
+            if (node == NULL)
+            {
+                result = FAILURE;
+                break;
+            }
+            node->right = spare;
+            spare = node;
+        }
+        Node *finger = NULL;
+        for (long unsigned i = 0; i < unique && result == SUCCESS; ++i)
+        {
+            Node *newNode = spare;
+            Node *nextSpare = spare->right;
+            *newNode = (Node) {.parentColor = (uintptr_t) RED, .right = NULL, .left = NULL, .data = items[i]};
+            kept[i] = (char) insertAfterFinger(tree, finger, newNode);
+            if (!kept[i])
+            {
+                newNode->right = nextSpare;
+                continue;
+            }
+            spare = nextSpare;
+            balanceNewNode(tree, newNode);
+            finger = newNode;
+        }
+        while (spare != NULL)
+        {
+            Node *next = spare->right;
+            recycleNode(tree, spare);
+            spare = next;
+        }
+        if (result == SUCCESS)
+        {
+            moveRejectedToEnd(items, buffer, kept, unique);
+        }
+    }
+    free(buffer);
+    free(kept);
+    return result;
+}
+
+/**
+ * @brief Finds the node with the data matching the input
+ * @param tree The RBTree to check
+ * @param data The data to check a match for
+ * @return The node matching data, NULL if not found
+ */
+Node *findNode(const RBTree *tree, const void *data)
+{
+    Node *found, *parent;
+    int side;
+    uint64_t prefix = keyPrefix(tree, data);
+    RBTREE_DESCEND(tree->root, cur, compareToNode(tree, data, prefix, cur), found, parent, side);
+    return found;
+}
+
+/**
+ * @param node The root of a non empty sub-tree.
+ * @return The node of the sub-tree with the smallest data.
+ */
+Node *RBTreeLeftmost(Node *node)
+{
+    while (node->left != NULL)
+    {
+        node = node->left;
+    }
+    return node;
+}
+
+/**
+ * @param node The root of a non empty sub-tree.
+ * @return The node of the sub-tree with the greatest data.
+ */
+static Node *rightmost(Node *node)
+{
+    while (node->right != NULL)
+    {
+        node = node->right;
+    }
+    return node;
+}
+
+/**
+ * @param node A node of a tree.
+ * @return The node that follows node in ascending order, NULL if node is the last one.
+ */
+static Node *nextNode(Node *node)
+{
+    if (node->right != NULL)
+    {
+        return RBTreeLeftmost(node->right);
+    }
+    Node *parent = getParent(node);
+    while (parent != NULL && parent->right == node)
+    {
+        node = parent;
+        parent = getParent(node);
+    }
+    return parent;
+}
+
+/**
+ * @param node A node of a tree.
+ * @return The node that precedes node in ascending order, NULL if node is the first one.
+ */
+static Node *prevNode(Node *node)
+{
+    if (node->left != NULL)
+    {
+        return rightmost(node->left);
+    }
+    Node *parent = getParent(node);
+    while (parent != NULL && parent->left == node)
+    {
+        node = parent;
+        parent = getParent(node);
+    }
+    return parent;
+}
+
+/**
+ * @brief Frees the data of a node as well as the node itself.
+ * @param tree The tree that contains the toFree to be freed.
+ * @param toFree The node to be freed.
+ * @return The amount of items freed.
+ */
+long unsigned freeNode(RBTree *tree, Node *toFree)
+{
+    if (toFree == NULL)
+    {
+        return NO_ITEMS;
+    }
+    long unsigned amount = freeNode(tree, toFree->left) + freeNode(tree, toFree->right) + 1;
+    freeItem(tree, toFree->data);
+    recycleNode(tree, toFree);
+    return amount;
+}
+
+/**
+ * @brief Removes a node from the tree, frees its item and gives back its memory.
+ * @param tree The tree containing node.
+ * @param node The node to delete.
+ */
+void RBTreeDeleteNode(RBTree *tree, Node *node)
+{
+    removeNode(tree, node);
+    freeItem(tree, node->data);
+    recycleNode(tree, node);
+    (tree->size)--;
+}
+
+/**
+ * remove an item from the tree
+ * @param tree: the tree to remove an item from.
+ * @param data: item to remove from the tree.
+ * @return: 0 on failure, other on success. (if data is not in the tree - failure).
+ */
+int deleteFromRBTree(RBTree *tree, void *data)
+{
+    if (tree == NULL)
+    {
+        return FAILURE;
+    }
+    // the search and the removal make one walk down: removeNode goes on from the found node to its successor, and
+    // only then fixes the colors on the way up, for at most three rotations. a top-down delete would make it one
+    // pass, but it recolors and rotates on every level it passes, even when the bottom up fix-up stops at once.
+    Node *toDelete = findNode(tree, data);
+    if (toDelete == NULL)
+    {
+        return FAILURE;
+    }
+    RBTreeDeleteNode(tree, toDelete);
+    return SUCCESS;
+}
+
+
+/**
+ * check whether the tree RBTreeContains this item.
+ * @param tree: the tree to add an item to.
+ * @param data: item to check.
+ * @return: 0 if the item is not in the tree, other if it is.
+ */
+int RBTreeContains(const RBTree *tree, const void *data)
+{
+    if (tree == NULL)
+    {
+        return FAILURE;
+    }
+    return (findNode(tree, data) != NULL);
+}
+
+/**
+ * recompute what the tree keeps for an item after the item changed. the change must not move the item in the order
+ * of the tree.
+ * @param tree: the tree that holds the item.
+ * @param data: the item that changed, or an item equal to it.
+ * @return: 0 on failure, other on success. (if data is not in the tree - failure).
+ */
+int refreshRBTreeItem(RBTree *tree, const void *data)
+{
+    if (tree == NULL || data == NULL)
+    {
+        return FAILURE;
+    }
+    Node *node = findNode(tree, data);
+    if (node == NULL)
+    {
+        return FAILURE;
+    }
+    fillCache(tree, node);
+    refreshPath(tree, node);
+    return SUCCESS;
+}
+
+/**
+ * Activate a function on each item of the sub-tree whose root is node. The order is an ascending order. if one of the activations of the
+ * function returns 0, the process stops.
+ * @param node The root of the sub-tree to check.
+ * @param func: the function to activate on all items.
+ * @param args: more optional arguments to the function (may be null if the given function support it).
+ * @return: 0 on failure, 1 on success.
+ */
+int forEachNode(Node *node, forEachFunc func, void *args)
+{
+    if (node == NULL)
+    {
+        return SUCCESS;
+    }
+    Node *cur = RBTreeLeftmost(node);
+    while (cur != NULL)
+    {
+        if (func(cur->data, args) == FAILURE)
+        {
+            return FAILURE;
+        }
+        if (cur->right != NULL)
+        {
+            cur = RBTreeLeftmost(cur->right);
+            continue;
+        }
+        while (cur != node && getParent(cur)->right == cur)
+        {
+            cur = getParent(cur);
+        }
+        cur = cur == node ? NULL : getParent(cur);
+    }
+    return SUCCESS;
+}
+
+/**
+ * Activate a function on each item of the tree. the order is an ascending order. if one of the activations of the
+ * function returns 0, the process stops.
+ * @param tree: the tree with all the items.
+ * @param func: the function to activate on all items.
+ * @param args: more optional arguments to the function (may be null if the given function support it).
+ * @return: 0 on failure, other on success.
+ */
+int forEachRBTree(const RBTree *tree, forEachFunc func, void *args)
+{
+    if (tree == NULL)
+    {
+        return FAILURE;
+    }
+    return forEachNode(tree->root, func, args);
+}
+
+/**
+ * @brief Moves an iterator to a node.
+ * @param iter The iterator to move.
+ * @param node The new position of iter, NULL for the end.
+ * @return The item of node, NULL for the end.
+ */
+static void *moveIterator(RBTreeIterator *iter, Node *node)
+{
+    iter->node = node;
+    return node != NULL ? node->data : NULL;
+}
+
+/**
+ * move an iterator to the first item of a tree.
+ * @param tree: the tree to walk over.
+ * @param iter: the iterator to set.
+ * @return: the first item, NULL if the tree is empty.
+ */
+void *RBTreeFirst(const RBTree *tree, RBTreeIterator *iter)
+{
+    iter->tree = tree;
+    return moveIterator(iter, tree->root != NULL ? RBTreeLeftmost(tree->root) : NULL);
+}
+
+/**
+ * move an iterator to the last item of a tree.
+ * @param tree: the tree to walk over.
+ * @param iter: the iterator to set.
+ * @return: the last item, NULL if the tree is empty.
+ */
+void *RBTreeLast(const RBTree *tree, RBTreeIterator *iter)
+{
+    iter->tree = tree;
+    return moveIterator(iter, tree->root != NULL ? rightmost(tree->root) : NULL);
+}
+
+/**
+ * move an iterator to the next item in ascending order. from the end it moves to the first item.
+ * @param iter: the iterator to move.
+ * @return: the next item, NULL if the iterator passed the last item.
+ */
+void *RBTreeNext(RBTreeIterator *iter)
+{
+    if (iter->node == NULL)
+    {
+        return RBTreeFirst(iter->tree, iter);
+    }
+    return moveIterator(iter, nextNode(iter->node));
+}
+
+/**
+ * move an iterator to the previous item in ascending order. from the end it moves to the last item.
+ * @param iter: the iterator to move.
+ * @return: the previous item, NULL if the iterator passed the first item.
+ */
+void *RBTreePrev(RBTreeIterator *iter)
+{
+    if (iter->node == NULL)
+    {
+        return RBTreeLast(iter->tree, iter);
+    }
+    return moveIterator(iter, prevNode(iter->node));
+}
+
+/**
+ * get the cache the tree keeps for the item at an iterator.
+ * @param iter: an iterator of a tree constructed with a cacheFunc.
+ * @return: the cache of the item, NULL at the end position or if the tree keeps no cache.
+ */
+const void *RBTreeCache(const RBTreeIterator *iter)
+{
+    if (iter->node == NULL)
+    {
+        return NULL;
+    }
+    return RBTreeItemCache(iter->tree, iter->node);
+}
+
+/**
+ * @brief Positions an iterator (if there is one) on a node of a tree.
+ * @param tree The tree of node.
+ * @param iter The iterator to set, may be NULL.
+ * @param node The node, NULL for the end.
+ * @return The item of node, NULL for the end.
+ */
+void *RBTreePlaceIterator(const RBTree *tree, RBTreeIterator *iter, Node *node)
+{
+    if (iter != NULL)
+    {
+        iter->tree = tree;
+        iter->node = node;
+    }
+    return node != NULL ? node->data : NULL;
+}
+
+/**
+ * @param tree The tree to search.
+ * @param key The key to compare with.
+ * @param orEqual Whether a node equal to key counts.
+ * @return The first node greater than key (or equal to it), NULL if there is none.
+ */
+static Node *firstAbove(const RBTree *tree, const void *key, int orEqual)
+{
+    Node *found;
+    uint64_t prefix = keyPrefix(tree, key);
+    // with orEqual, a node is above key if key compares to it below RIGHT (as smaller or equal), else below EQUAL.
+    int bound = orEqual ? RIGHT : EQUAL;
+    RBTREE_FIRST_ABOVE(tree->root, cur, compareToNode(tree, key, prefix, cur) < bound, found);
+    return found;
+}
+
+/**
+ * @param tree The tree to search.
+ * @param key The key to compare with.
+ * @param orEqual Whether a node equal to key counts.
+ * @return The last node smaller than key (or equal to it), NULL if there is none.
+ */
+static Node *lastBelow(const RBTree *tree, const void *key, int orEqual)
+{
+    Node *cur = tree->root, *found = NULL;
+    uint64_t prefix = keyPrefix(tree, key);
+    while (cur != NULL)
+    {
+        int compRes = compareToNode(tree, key, prefix, cur);
+        if (compRes > EQUAL || (orEqual && compRes == EQUAL))
+        {
+            found = cur;
+            cur = cur->right;
+        }
+        else
+        {
+            cur = cur->left;
+        }
+    }
+    return found;
+}
+
+/**
+ * find the first item that is not smaller than key.
+ * @param tree: the tree to search.
+ * @param key: the key to compare the items with (it does not have to be in the tree).
+ * @param iter: an iterator to place on the found item or on the end, may be NULL.
+ * @return: the found item, NULL if there is none.
+ */
+void *RBTreeLowerBound(const RBTree *tree, const void *key, RBTreeIterator *iter)
+{
+    return RBTreePlaceIterator(tree, iter, firstAbove(tree, key, INCLUSIVE));
+}
+
+/**
+ * find the first item that is greater than key.
+ * @param tree: the tree to search.
+ * @param key: the key to compare the items with (it does not have to be in the tree).
+ * @param iter: an iterator to place on the found item or on the end, may be NULL.
+ * @return: the found item, NULL if there is none.
+ */
+void *RBTreeUpperBound(const RBTree *tree, const void *key, RBTreeIterator *iter)
+{
+    return RBTreePlaceIterator(tree, iter, firstAbove(tree, key, EXCLUSIVE));
+}
+
+/**
+ * find the greatest item that is smaller than or equal to key.
+ * @param tree: the tree to search.
+ * @param key: the key to compare the items with (it does not have to be in the tree).
+ * @param iter: an iterator to place on the found item or on the end, may be NULL.
+ * @return: the found item, NULL if there is none.
+ */
+void *RBTreeFloor(const RBTree *tree, const void *key, RBTreeIterator *iter)
+{
+    return RBTreePlaceIterator(tree, iter, lastBelow(tree, key, INCLUSIVE));
+}
+
+/**
+ * find the smallest item that is greater than or equal to key (the same item as RBTreeLowerBound).
+ * @param tree: the tree to search.
+ * @param key: the key to compare the items with (it does not have to be in the tree).
+ * @param iter: an iterator to place on the found item or on the end, may be NULL.
+ * @return: the found item, NULL if there is none.
  */
-int getSide(Node const *const child)
+void *RBTreeCeiling(const RBTree *tree, const void *key, RBTreeIterator *iter)
 {
-    if (child == NULL)
-    {
-        return FAILURE;
-    }
-    Node *parent = child->parent;
-    if (parent == NULL)
+    return RBTreeLowerBound(tree, key, iter);
+}
+
+/**
+ * Activate a function on each item of the tree between lo and hi (both included). the order is an ascending order.
+ * if one of the activations of the function returns 0, the process stops. only the nodes on the paths to the range
+ * and inside it are visited.
+ * @param tree: the tree with all the items.
+ * @param lo: the smallest key of the range (it does not have to be in the tree).
+ * @param hi: the greatest key of the range (it does not have to be in the tree).
+ * @param func: the function to activate on the items.
+ * @param args: more optional arguments to the function (may be null if the given function support it).
+ * @return: 0 on failure, other on success.
+ */
+int forEachRBTreeInRange(const RBTree *tree, const void *lo, const void *hi, forEachFunc func, void *args)
+{
+    if (tree == NULL)
     {
         return FAILURE;
     }
-    if (child == parent->left)
+    Node *cur = firstAbove(tree, lo, INCLUSIVE);
+    uint64_t hiPrefix = keyPrefix(tree, hi);
+    while (cur != NULL && compareToNode(tree, hi, hiPrefix, cur) >= EQUAL)
     {
-        return LEFT;
+        if (func(cur->data, args) == FAILURE)
+        {
+            return FAILURE;
+        }
+        cur = nextNode(cur);
     }
-    return RIGHT;
+    return SUCCESS;
 }
 
 /**
- * @brief Rotates a sub-tree so that the child will become the parent
- * @param child A left or a right child of the parent.
- * @param parent A node which is the old root of the sub-tree.
+ * get the summary of all the items of a tree for one of its augmentations, in O(1).
+ * @param tree: a tree constructed with augmentations.
+ * @param augmentation: the index of the augmentation in the options of the tree.
+ * @return: the summary, NULL if the tree is empty or has no such augmentation. it is valid until the tree changes.
  */
-void rotate(RBTree *tree, Node *child, Node *parent)
+const void *RBTreeSummary(const RBTree *tree, int augmentation)
 {
-    int childSide = getSide(child);
-    if (parent->parent == NULL)
+    if (tree == NULL || augmentation < 0 || augmentation >= tree->augmentationsAmount || tree->root == NULL)
     {
-        tree->root = child;
-        child->parent = NULL;
+        return NULL;
     }
-    else
+    return subtreeSummary(&tree->augmentations[augmentation], tree->root);
+}
+
+/**
+ * @brief Adds one item and the sub-tree between it and a range to the summary of the range.
+ * @param tree The tree the summaries belong to.
+ * @param augmentation The augmentation of the summaries.
+ * @param summary The summary of the range so far.
+ * @param piece Room for the summary of one item.
+ * @param node The node of the item.
+ * @param inner The sub-tree between node and the items of summary, may be NULL.
+ * @param side LEFT if node and inner are smaller than the items of summary, RIGHT if they are greater.
+ */
+static void addToSummary(const RBTree *tree, const RBTreeAugmentation *augmentation, void *summary, void *piece,
+                  const Node *node, const Node *inner, int side)
+{
+    augmentation->summarizeFunc(piece, node->data, RBTreeItemCache(tree, node));
+    if (inner != NULL)
     {
-        int parentSide = getSide(parent);
-        child->parent = parent->parent;
-        if (parentSide == LEFT)
+        if (side == LEFT)
         {
-            parent->parent->left = child;
+            augmentation->mergeFunc(summary, subtreeSummary(augmentation, inner), summary);
         }
         else
         {
-            parent->parent->right = child;
+            augmentation->mergeFunc(summary, summary, subtreeSummary(augmentation, inner));
         }
     }
-    if (childSide == LEFT)
+    if (side == LEFT)
     {
-        connectNodes(tree, parent, child->right, LEFT);
-        connectNodes(tree, child, parent, RIGHT);
+        augmentation->mergeFunc(summary, piece, summary);
     }
     else
     {
-        connectNodes(tree, parent, child->left, RIGHT);
-        connectNodes(tree, child, parent, LEFT);
+        augmentation->mergeFunc(summary, summary, piece);
     }
 }
 
 /**
- * @brief Modifies the RBTree in case the node with the DB violation has a black uncle.
- * @param tree The RBTree containing all of the nodes.
- * @param gParent The grand parent of the node with the DB violation.
- * @param parent The parent of the node with the DB violation.
- * @param node The node with the DB violation.
- * @param parentSide The side of gParent parent is connected to.
- * @return The of node.
+ * get the summary of the items of a tree between lo and hi (both included) for one of its augmentations, in
+ * O(log n). the range is covered by the summaries of O(log n) sub-trees and items, merged in order.
+ * @param tree: a tree constructed with augmentations.
+ * @param augmentation: the index of the augmentation in the options of the tree.
+ * @param lo: the smallest key of the range (it does not have to be in the tree).
+ * @param hi: the greatest key of the range (it does not have to be in the tree).
+ * @param summary: receives the summary, of the summarySize of the augmentation.
+ * @return: 0 on failure, other on success. (if the range has no items or the tree has no such augmentation -
+ * failure).
  */
-Color updateColorBlackUncle(RBTree *tree, Node *gParent, Node *parent, Node *node, int parentSide)
+int RBTreeRangeSummary(const RBTree *tree, int augmentation, const void *lo, const void *hi, void *summary)
 {
-        int childSide = getSide(node);
-        if (childSide != parentSide)
+    if (tree == NULL || augmentation < 0 || augmentation >= tree->augmentationsAmount || summary == NULL)
+    {
+        return FAILURE;
+    }
+    const RBTreeAugmentation *augmented = &tree->augmentations[augmentation];
+    uint64_t loPrefix = keyPrefix(tree, lo), hiPrefix = keyPrefix(tree, hi);
+    Node *top = tree->root;
+    while (top != NULL)
+    {
+        if (compareToNode(tree, lo, loPrefix, top) > EQUAL)
         {
-            rotate(tree, node, parent);
-            parent = node;
+            top = top->right;
         }
-        rotate(tree, parent, gParent);
-        parent->color = BLACK, gParent->color = RED;
-        if (node == parent)
+        else if (compareToNode(tree, hi, hiPrefix, top) < EQUAL)
         {
-            return BLACK;
+            top = top->left;
+        }
+        else
+        {
+            break;
         }
-        return RED;
-}
-
-/**
- * @brief Updates the node colors starting from node up
- * @param node The node to start the update from
- * @return The color of node.
- */
-Color updateColors(RBTree *tree, Node *node)
-{
-    Node *parent = node->parent;
-    if (parent == NULL)
-    {
-        return BLACK;
     }
-    if (parent->color == BLACK)
+    if (top == NULL)
     {
-        return RED;
+        return FAILURE;
     }
-    Node *gParent = parent->parent;
-    Node *uncle;
-    int parentSide = getSide(parent);
-    if (parentSide == LEFT)
+    void *piece = malloc(augmented->summarySize);
+    if (piece == NULL)
     {
-        uncle = gParent->right;
+        return FAILURE;
     }
-    else
+    augmented->summarizeFunc(summary, top->data, RBTreeItemCache(tree, top));
+    for (Node *cur = top->left; cur != NULL;)
     {
-        uncle = gParent->left;
+        if (compareToNode(tree, lo, loPrefix, cur) > EQUAL)
+        {
+            cur = cur->right;
+            continue;
+        }
+        addToSummary(tree, augmented, summary, piece, cur, cur->right, LEFT);
+        cur = cur->left;
     }
-    if (uncle == NULL || uncle->color == BLACK)
+    for (Node *cur = top->right; cur != NULL;)
     {
-        return updateColorBlackUncle(tree, gParent, parent, node, parentSide);
+        if (compareToNode(tree, hi, hiPrefix, cur) < EQUAL)
+        {
+            cur = cur->left;
+            continue;
+        }
+        addToSummary(tree, augmented, summary, piece, cur, cur->left, RIGHT);
+        cur = cur->right;
     }
-    parent->color = BLACK, uncle->color = BLACK;
-    gParent->color = updateColors(tree, gParent);
-    return RED;
+    free(piece);
+    return SUCCESS;
 }
 
 /**
- * @brief Inserts a new node to a RBtree in the right position.
- * @param tree The tree to insert the node to.
- * @param newNode The node to insert.
- * @return 1 upon success, 0 if there is a node with the same data as newNode's already in tree.
+ * count the items of the tree that are smaller than data. O(log n) if the tree keeps order statistics, otherwise the
+ * smaller items are walked over.
+ * @param tree: the tree to count in.
+ * @param data: the key to compare the items with (it does not have to be in the tree).
+ * @return: the amount of items smaller than data, which is the index of data if it is in the tree.
  */
-int insertNode(RBTree *tree, Node *newNode)
+long unsigned RBTreeRank(const RBTree *tree, const void *data)
 {
-    Node *curNode = tree->root;
-    Node *parent;
-    int side;
-    int compRes;
-    while (curNode != NULL)
+    long unsigned rank = NO_ITEMS;
+    if (tree == NULL)
+    {
+        return rank;
+    }
+    uint64_t prefix = keyPrefix(tree, data);
+    if (tree->countOffset == NOT_KEPT)
     {
-        compRes = tree->compFunc(newNode->data, curNode->data);
-        if (compRes == EQUAL)
+        for (Node *cur = tree->root != NULL ? RBTreeLeftmost(tree->root) : NULL;
+             cur != NULL && compareToNode(tree, data, prefix, cur) > EQUAL; cur = nextNode(cur))
         {
-            free(newNode);
-            return FAILURE;
+            rank++;
         }
-        parent = curNode;
-        if (compRes < EQUAL)
+        return rank;
+    }
+    Node *cur = tree->root;
+    while (cur != NULL)
+    {
+        int compRes = compareToNode(tree, data, prefix, cur);
+        if (compRes <= EQUAL)
         {
-            side = LEFT;
-            curNode = curNode->left;
+            if (compRes == EQUAL)
+            {
+                return rank + RBTreeSubtreeCount(tree, cur->left);
+            }
+            cur = cur->left;
         }
         else
         {
-            side = RIGHT;
-            curNode = curNode->right;
+            rank += RBTreeSubtreeCount(tree, cur->left) + 1;
+            cur = cur->right;
         }
     }
-    connectNode(tree, newNode, parent, side);
-    return SUCCESS;
+    return rank;
 }
 
 /**
- * add an item to the tree
- * @param tree: the tree to add an item to.
- * @param data: item to add to the tree.
- * @return: 0 on failure, other on success. (if the item is already in the tree - failure).
+ * find the item at an index of the ascending order. O(log n) if the tree keeps order statistics, otherwise the
+ * preceding items are walked over.
+ * @param tree: the tree to search.
+ * @param index: the amount of items smaller than the wanted one.
+ * @return: the item, NULL if index is not smaller than the size of the tree.
  */
-int insertToRBTree(RBTree *tree, void *data)
+void *RBTreeSelect(const RBTree *tree, long unsigned index)
 {
-    if (tree == NULL)
-    {
-        return FAILURE;
-    }
-    if (data == NULL)
-    {
-        return FAILURE;
-    }
-    Node *newNode = (Node *) malloc(sizeof(Node));
-    if (newNode == NULL)
+    if (tree == NULL || index >= tree->size)
     {
-        return FAILURE;
-    }
-    *newNode = (Node) {.parent = NULL, .right = NULL, .left = NULL, .data = data, .color = BLACK};
-    if (tree->root == NULL)
-    {
-        tree->root = newNode;
-        tree->size++;
-        return SUCCESS;
+        return NULL;
     }
-    if (!insertNode(tree, newNode))
+    Node *cur = tree->root;
+    if (tree->countOffset == NOT_KEPT)
     {
-        return FAILURE;
+        for (cur = RBTreeLeftmost(cur); index > NO_ITEMS; --index)
+        {
+            cur = nextNode(cur);
+        }
+        return cur->data;
     }
-    newNode->color = updateColors(tree, newNode);
-    (tree->size)++;
-    return SUCCESS;
-}
-
-/**
- * @brief Finds the node with the data matching the input
- * @param tree The RBTree to check
- * @param data The data to check a match for
- * @return The node matching data, NULL if not found
- */
-Node *findNode(const RBTree *tree, const void *data)
-{
-    int compRes;
-    Node *curNode = tree->root;
-    while (curNode != NULL)
+    while (cur != NULL)
     {
-        compRes = tree->compFunc(data, curNode->data);
-        if (compRes == EQUAL)
+        long unsigned leftCount = RBTreeSubtreeCount(tree, cur->left);
+        if (index == leftCount)
         {
-            return curNode;
+            return cur->data;
         }
-        if (compRes < EQUAL)
+        if (index < leftCount)
         {
-            curNode = curNode->left;
+            cur = cur->left;
         }
         else
         {
-            curNode = curNode->right;
+            index -= leftCount + 1;
+            cur = cur->right;
         }
     }
     return NULL;
 }
 
 /**
- * Gets the node which it's data is the successor of node, if node has right a child
- * @param node The node whose successor needed to be found
- * @return A pointer to the Node pointer of node's successor
+ * @param node The root of a sub-tree, may be NULL.
+ * @return The amount of black nodes on a path from node (included) down to an empty sub-tree.
  */
-Node *findSuccessor(Node *node)
+static int blackHeight(const Node *node)
 {
-    Node *child = node->right;
-    while (child != NULL)
+    int height = 0;
+    for (; node != NULL; node = node->left)
     {
-        if (child->left != NULL)
-        {
-            child = child->left;
-        }
-        else
-        {
-            break;
-        }
+        height += (getColor(node) == BLACK);
     }
-    return child;
+    return height;
 }
 
 /**
- * @brief Frees the data of a node as well as the node itself.
- * @param tree The tree that contains the toFree to be freed.
- * @param toFree The node to be freed.
+ * @brief Joins two sub-trees and a node between them into one sub-tree, in time proportional to the difference of
+ * their black heights. The pivot is hung at the edge of the taller sub-tree where the heights match, and the RB rules
+ * are then restored like after an insertion.
+ * @param tree The tree the nodes belong to.
+ * @param left The root of the sub-tree of smaller items, black or NULL, with no parent.
+ * @param leftHeight The black height of left.
+ * @param pivot A node between the two sub-trees.
+ * @param right The root of the sub-tree of greater items, black or NULL, with no parent.
+ * @param rightHeight The black height of right.
+ * @param height Receives the black height of the joined sub-tree.
+ * @return The black root of the joined sub-tree.
  */
-void freeNode(RBTree *tree, Node *toFree)
+static Node *joinNodes(const RBTree *tree, Node *left, int leftHeight, Node *pivot, Node *right, int rightHeight,
+                int *height)
 {
-    if (toFree == NULL)
+    RBTree sub = *tree;
+    if (leftHeight == rightHeight)
     {
-        return;
+        *pivot = (Node) {.parentColor = (uintptr_t) BLACK, .left = left, .right = right, .data = pivot->data};
+        connectNode(&sub, left, pivot, LEFT);
+        connectNode(&sub, right, pivot, RIGHT);
+        refreshNode(&sub, pivot);
+        *height = leftHeight + 1;
+        return pivot;
     }
-    freeNode(tree, toFree->left);
-    freeNode(tree, toFree->right);
-    (tree->freeFunc)(toFree->data);
-    free(toFree);
+    int intoLeft = leftHeight > rightHeight;
+    Node *cur = intoLeft ? left : right;
+    Node *parent = NULL;
+    int curHeight = intoLeft ? leftHeight : rightHeight;
+    int targetHeight = intoLeft ? rightHeight : leftHeight;
+    sub.root = cur;
+    while (cur != NULL && (curHeight > targetHeight || getColor(cur) == RED))
+    {
+        curHeight -= (getColor(cur) == BLACK);
+        parent = cur;
+        cur = intoLeft ? cur->right : cur->left;
+    }
+    *pivot = (Node) {.parentColor = (uintptr_t) RED, .left = NULL, .right = NULL, .data = pivot->data};
+    connectNode(&sub, intoLeft ? cur : left, pivot, LEFT);
+    connectNode(&sub, intoLeft ? right : cur, pivot, RIGHT);
+    connectNode(&sub, pivot, parent, intoLeft ? RIGHT : LEFT);
+    refreshPath(&sub, pivot);
+    fixInsertion(&sub, pivot);
+    *height = intoLeft ? leftHeight : rightHeight;
+    if (getColor(sub.root) == RED)
+    {
+        setColor(sub.root, BLACK);
+        (*height)++;
+    }
+    return sub.root;
 }
 
 /**
- * @param node The node whose children are to be checked
- * @return A pointer to node's child if the other child is NULL, NULL otherwise.
+ * @brief Detaches a child sub-tree from its parent, making its root black.
+ * @param node The root of the sub-tree, may be NULL.
+ * @param height The black height of node.
+ * @param newHeight Receives the black height of the detached sub-tree.
+ * @return node.
  */
-Node *getSingleChild(Node *node)
+static Node *detachSubtree(Node *node, int height, int *newHeight)
 {
-    if (node->left == NULL && node->right != NULL)
+    *newHeight = height;
+    if (node == NULL)
     {
-        return node->right;
+        return NULL;
     }
-    else if (node->left != NULL && node->right == NULL)
+    if (getColor(node) == RED)
     {
-        return node->left;
+        (*newHeight)++;
     }
-    return NULL;
+    node->parentColor = (uintptr_t) BLACK;
+    return node;
 }
 
 /**
- * @brief Connects two nodes.
- * @param parent The node that is connected as the parent.
- * @param child The node that is connected as the child.
- * @param side The side of the parent to connect child to.
+ * @brief Splits a sub-tree into the nodes smaller than key, the node equal to it and the nodes greater than it,
+ * joining the pieces on the way back up.
+ * @param tree The tree the nodes belong to.
+ * @param node The black root of the sub-tree, with no parent, may be NULL.
+ * @param height The black height of node.
+ * @param key The key to split by.
+ * @param prefix The prefix of key, from keyPrefix.
+ * @param less Receives the root of the smaller nodes.
+ * @param lessHeight Receives the black height of less.
+ * @param found Receives the node equal to key with no links, NULL if there is none.
+ * @param greater Receives the root of the greater nodes.
+ * @param greaterHeight Receives the black height of greater.
  */
-void connectNodes(RBTree *tree, Node *parent, Node *child, int side)
+static void splitNodes(const RBTree *tree, Node *node, int height, const void *key, uint64_t prefix, Node **less,
+                int *lessHeight, Node **found, Node **greater, int *greaterHeight)
 {
-    if (parent == NULL)
+    if (node == NULL)
     {
-        tree->root = child;
+        *less = NULL, *found = NULL, *greater = NULL;
+        *lessHeight = 0, *greaterHeight = 0;
+        return;
     }
-    else
+    int leftHeight, rightHeight, restHeight;
+    Node *rest;
+    Node *left = detachSubtree(node->left, height - 1, &leftHeight);
+    Node *right = detachSubtree(node->right, height - 1, &rightHeight);
+    int compRes = compareToNode(tree, key, prefix, node);
+    if (compRes == EQUAL)
     {
-        if (side == LEFT)
-        {
-            parent->left = child;
-        }
-        else
-        {
-            parent->right = child;
-        }
+        *less = left, *greater = right;
+        *lessHeight = leftHeight, *greaterHeight = rightHeight;
+        *node = (Node) {.parentColor = (uintptr_t) BLACK, .left = NULL, .right = NULL, .data = node->data};
+        *found = node;
+    }
+    else if (compRes > EQUAL)
+    {
+        splitNodes(tree, right, rightHeight, key, prefix, &rest, &restHeight, found, greater, greaterHeight);
+        *less = joinNodes(tree, left, leftHeight, node, rest, restHeight, lessHeight);
     }
-    if (child != NULL)
+    else
     {
-        child->parent = parent;
+        splitNodes(tree, left, leftHeight, key, prefix, less, lessHeight, found, &rest, &restHeight);
+        *greater = joinNodes(tree, rest, restHeight, node, right, rightHeight, greaterHeight);
     }
 }
 
 /**
- * @brief Switches the place and color of two nodes.
- * @param highNode The node which is higher in the tree.
- * @param lowNode The node which is lower in the tree.
+ * move the items of a tree that are greater than or equal to key into a new tree, in O(log n). the new tree is made
+ * by newRBTreeLike. the tree must keep order statistics, which give the sizes of both trees in O(1).
+ * @param tree: the tree to split, keeps the items smaller than key.
+ * @param key: the key to split by (it does not have to be in the tree).
+ * @return: the tree of the items greater than or equal to key, NULL on failure (if the tree keeps no order
+ * statistics or an allocation fails - failure, and the tree is not changed).
  */
-void switchNodes(RBTree *tree, Node *highNode, Node *lowNode)
+RBTree *splitRBTree(RBTree *tree, const void *key)
 {
-    Node *highParent = highNode->parent;
-    Node *highRight = highNode->right;
-    Node *highLeft = highNode->left;
-    Color highCol = highNode->color;
-    int highSide = getSide(highNode);
-    int lowSide = getSide(lowNode);
-    connectNodes(tree, highNode, lowNode->left, LEFT);
-    connectNodes(tree, highNode, lowNode->right, RIGHT);
-    if (lowNode->parent != highNode)
+    if (tree == NULL || tree->countOffset == NOT_KEPT)
     {
-        connectNodes(tree, lowNode->parent, highNode, lowSide);
-        connectNodes(tree, lowNode, highRight, RIGHT);
-        connectNodes(tree, lowNode, highLeft, LEFT);
+        return NULL;
     }
-    else
+    RBTree *greater = newRBTreeLike(tree);
+    if (greater == NULL)
     {
-        connectNodes(tree, lowNode, highNode, lowSide);
-        if (lowSide == LEFT)
-        {
-            connectNodes(tree, lowNode, highRight, RIGHT);
-        }
-        else
-        {
-            connectNodes(tree, lowNode, highLeft, LEFT);
-        }
+        return NULL;
     }
-    connectNodes(tree, highParent, lowNode, highSide);
-    highNode->color = lowNode->color;
-    lowNode->color = highCol;
+    int lessHeight, greaterHeight;
+    Node *found;
+    splitNodes(tree, tree->root, blackHeight(tree->root), key, keyPrefix(tree, key), &tree->root, &lessHeight, &found,
+               &greater->root, &greaterHeight);
+    if (found != NULL)
+    {
+        greater->root = joinNodes(tree, NULL, 0, found, greater->root, greaterHeight, &greaterHeight);
+    }
+    greater->size = RBTreeSubtreeCount(greater, greater->root);
+    tree->size -= greater->size;
+    return greater;
 }
 
 /**
- * @brief Solves DB in case the violating node has a black sibling and its close nephew is red.
- * @param tree The RBTree containing all of the nodes.
- * @param siblingP A pointer to a pointer to the sibling of the violating node.
- * @param childSide The side of parent the violating node is connected to.
+ * move pivot and all the items of another tree into a tree, in O(log n). all the items of tree must be smaller than
+ * pivot, and pivot smaller than all the items of other. the trees must share nodes (see newRBTreeLike).
+ * @param tree: the tree of the small items, receives all the items.
+ * @param pivot: an item between the items of the two trees, may be NULL to only concatenate the trees.
+ * @param other: pointer to the tree of the great items, freed on success.
+ * @return: 0 on failure, other on success. (if the items are not in order or the trees do not share nodes - failure,
+ * and the trees are not changed).
  */
-void closeRedNephewDB(RBTree *tree, Node **siblingP, int childSide)
+int joinRBTree(RBTree *tree, void *pivot, RBTree **other)
 {
-    if (childSide == LEFT && (*siblingP)->left != NULL && (*siblingP)->left->color == RED)
+    if (tree == NULL || other == NULL || *other == NULL || !canShareNodes(tree, *other))
+    {
+        return FAILURE;
+    }
+    RBTree *right = *other;
+    Node *leftMax = tree->root != NULL ? rightmost(tree->root) : NULL;
+    Node *rightMin = right->root != NULL ? RBTreeLeftmost(right->root) : NULL;
+    if ((pivot != NULL && leftMax != NULL && tree->compFunc(leftMax->data, pivot) >= EQUAL) ||
+        (pivot != NULL && rightMin != NULL && tree->compFunc(pivot, rightMin->data) >= EQUAL) ||
+        (leftMax != NULL && rightMin != NULL && tree->compFunc(leftMax->data, rightMin->data) >= EQUAL))
+    {
+        return FAILURE;
+    }
+    Node *pivotNode = rightMin;
+    if (pivot != NULL)
+    {
+        pivotNode = allocNode(tree);
+        if (pivotNode == NULL)
+        {
+            return FAILURE;
+        }
+        pivotNode->data = pivot;
+        fillCache(tree, pivotNode);
+        (tree->size)++;
+    }
+    else if (rightMin != NULL)
     {
-        (*siblingP)->left->color = BLACK;
-        (*siblingP)->color = RED;
-        rotate(tree, (*siblingP)->left, (*siblingP));
+        removeNode(right, rightMin);
     }
-    else if (childSide == RIGHT && (*siblingP)->right != NULL && (*siblingP)->right->color == RED)
+    if (pivotNode != NULL)
     {
-        (*siblingP)->right->color = BLACK;
-        (*siblingP)->color = RED;
-        rotate(tree, (*siblingP)->right, (*siblingP));
+        int height;
+        tree->root = joinNodes(tree, tree->root, blackHeight(tree->root), pivotNode, right->root,
+                               blackHeight(right->root), &height);
     }
+    tree->size += right->size;
+    right->root = NULL;
+    freeRBTree(other);
+    return SUCCESS;
 }
 
 /**
- * @brief Solves DB in case the violating node has a black sibling and its far nephew is red.
- * @param tree The RBTree containing all of the nodes.
- * @param parentP A pointer to a pointer to the parent of the violating node.
- * @param siblingP A pointer to a pointer to the sibling of the violating node.
- * @param childSide The side of parent the violating node is connected to.
+ * @brief Puts a sub-tree aside to be freed once a set operation is done. The list is chained through the parent
+ * field of the roots, which the sub-trees no longer need.
+ * @param node The root of the sub-tree, its children (if any) are discarded with it. may be NULL.
+ * @param discards The list of discarded sub-trees.
  */
-void farRedNephewDB(RBTree *tree, Node **parentP, Node **siblingP, int childSide)
+static void discardSubtree(Node *node, Discards *discards)
 {
-    if ((childSide == LEFT && (*siblingP)->right != NULL && (*siblingP)->right->color == RED) ||
-        (childSide == RIGHT && (*siblingP)->left != NULL && (*siblingP)->left->color == RED))
+    if (node != NULL)
     {
-        Color temp = (*siblingP)->color;
-        (*siblingP)->color = (*parentP)->color;
-        (*parentP)->color = temp;
-        if ((*siblingP)->right != NULL && (*siblingP)->right->color == RED)
+        node->parentColor = (uintptr_t) NULL;
+        if (discards->last != NULL)
         {
-            (*siblingP)->right->color = BLACK;
+            discards->last->parentColor = (uintptr_t) node;
         }
         else
         {
-            (*siblingP)->left->color = BLACK;
+            discards->first = node;
         }
-        rotate(tree, *siblingP, *parentP);
+        discards->last = node;
     }
 }
 
 /**
- * @brief Solves DB in case the violating node has a black sibling.
- * @param tree The RBTree containing all of the nodes.
- * @param parentP A pointer to a pointer to the parent of the violating node.
- * @param siblingP A pointer to a pointer to the sibling of the violating node.
- * @param childP A pointer to a pointer to the violating node.
- * @param childSide The side of parent the violating node is connected to.
+ * @brief Moves the sub-trees of one discard list to the end of another.
+ * @param discards The list to add to.
+ * @param more The list to empty.
  */
-void blackSiblingDB(RBTree *tree, Node **parentP, Node **siblingP, Node **childP, int childSide)
+static void appendDiscards(Discards *discards, Discards *more)
 {
-    if ((*siblingP)->left == NULL || (*siblingP)->left->color == BLACK)
+    if (more->first != NULL)
     {
-        if ((*siblingP)->right == NULL || (*siblingP)->right->color == BLACK)
+        if (discards->last != NULL)
         {
-            (*siblingP)->color = RED;
-            if ((*parentP)->color == RED)
-            {
-                (*parentP)->color = BLACK;
-            }
-            else
-            {
-                solveDB(tree, &((*parentP)->parent), parentP, getSide((*parentP)));
-                return;
-            }
+            discards->last->parentColor = (uintptr_t) more->first;
+        }
+        else
+        {
+            discards->first = more->first;
         }
+        discards->last = more->last;
+        *more = (Discards) {.first = NULL, .last = NULL};
     }
-    closeRedNephewDB(tree, siblingP, childSide);
-    *siblingP = (*parentP)->left == (*childP) ? (*parentP)->right : (*parentP)->left;
-    farRedNephewDB(tree, parentP, siblingP, childSide);
 }
 
 /**
- * @brief Solves recursively a problem of double black upon deletion.
- * @param tree The tree containing all of the nodes.
- * @param parent The parent of the node where the violation happened.
- * @param child The node that violates the RB rules.
- * @param childSide The side of the child as a child of parent.
+ * @brief Frees a list of discarded sub-trees.
+ * @param tree The tree the nodes belong to.
+ * @param discards The list.
+ * @return The amount of items freed.
  */
-void solveDB(RBTree *tree, Node **parentP, Node **childP, int childSide)
+static long unsigned freeDiscards(RBTree *tree, Discards *discards)
 {
-    if (*parentP == NULL)
-    {
-        return;
-    }
-    Node **siblingP = (*parentP)->left == (*childP) ? &((*parentP)->right) : &((*parentP)->left);
-    if ((*siblingP)->color == RED)
-    {
-        (*siblingP)->color = BLACK, (*parentP)->color = RED;
-        rotate(tree, *siblingP, *parentP);
-        solveDB(tree, parentP, childP, childSide);
-    }
-    else
+    long unsigned amount = NO_ITEMS;
+    Node *node = discards->first;
+    while (node != NULL)
     {
-        blackSiblingDB(tree, parentP, siblingP, childP, childSide);
+        Node *next = (Node *) node->parentColor;
+        amount += freeNode(tree, node);
+        node = next;
     }
+    return amount;
 }
 
 /**
- * @brief Deals with the first stage of deletion - switches the node to be deleted with it's succesor if needed.
- * @param tree The RBTree
- * @param toSwitch The node to be switched
- * @param childPtr A pointer to the place to hold toSwitch's child
- * @return 0 upon failure, 1 otherwise.
+ * @brief Joins two sub-trees with no node between them, by taking the smallest node of right as the pivot.
+ * @param tree The tree the nodes belong to.
+ * @param left The root of the sub-tree of smaller items, black or NULL, with no parent.
+ * @param leftHeight The black height of left.
+ * @param right The root of the sub-tree of greater items, black or NULL, with no parent.
+ * @param rightHeight The black height of right.
+ * @param height Receives the black height of the joined sub-tree.
+ * @return The black root of the joined sub-tree.
  */
-int placeBeforeDeletion(RBTree *tree, Node *toSwitch, Node **childPtr)
+static Node *concatNodes(const RBTree *tree, Node *left, int leftHeight, Node *right, int rightHeight, int *height)
 {
-    if (toSwitch == NULL)
+    if (right == NULL)
     {
-        return FAILURE;
-    }
-    *childPtr = getSingleChild(toSwitch);
-    if (*childPtr != NULL)
-    {
-        switchNodes(tree, toSwitch, *childPtr);
-    }
-    else if (toSwitch->right != NULL && toSwitch->left != NULL)
-    {
-        Node *suc = findSuccessor(toSwitch);
-        switchNodes(tree, toSwitch, suc);
+        *height = leftHeight;
+        return left;
     }
-    return SUCCESS;
+    RBTree sub = *tree;
+    sub.root = right;
+    Node *pivot = RBTreeLeftmost(right);
+    removeNode(&sub, pivot);
+    rightHeight = blackHeight(sub.root);
+    return joinNodes(tree, left, leftHeight, pivot, sub.root, rightHeight, height);
 }
 
 /**
- * @brief Disconnects the node to be deleted and balances the tree.
- * @param tree: the tree to remove an item from.
- * @param parentP A pointer to a pointer to the parent of the violating node.
- * @param toDeleteP A pointer to a pointer the node to be deleted.
- * @param childP A pointer to a pointer to the child of the node to be deleted.
- * @param toDeleteSide The side of the toDelete as a child of parent.
+ * @brief Combines two sub-trees by a set operation. The root of a is used to split b, the halves are combined
+ * recursively and then joined back, with or without the root of a. Items of b that equal items of a are always
+ * discarded, so the items of a are the ones kept. The halves are combined by the combineHalves of the job if it has
+ * one (each into its own discard list), otherwise one after the other.
+ * @param job The sub-trees to combine, receives the result.
  */
-void balanceTree(RBTree *tree, Node **parentP, Node **toDeleteP, Node **childP, int toDeleteSide)
+void RBTreeCombineNodes(CombineJob *job)
 {
-    if ((*toDeleteP)->color == RED)
+    Node *a = job->a, *b = job->b;
+    if (a == NULL || b == NULL)
+    {
+        int operation = job->operation;
+        job->result = operation == UNITE ? (a != NULL ? a : b) : (operation == SUBTRACT ? a : NULL);
+        job->height = job->result == a ? job->aHeight : (job->result == b ? job->bHeight : 0);
+        discardSubtree(a != job->result ? a : NULL, &job->discards);
+        discardSubtree(b != job->result ? b : NULL, &job->discards);
+        return;
+    }
+    CombineJob left = *job, right = *job;
+    Node *found;
+    left.a = detachSubtree(a->left, job->aHeight - 1, &left.aHeight);
+    right.a = detachSubtree(a->right, job->aHeight - 1, &right.aHeight);
+    splitNodes(job->tree, b, job->bHeight, a->data, nodePrefix(job->tree, a), &left.b, &left.bHeight, &found,
+               &right.b, &right.bHeight);
+    discardSubtree(found, &job->discards);
+    left.discards = (Discards) {.first = NULL, .last = NULL};
+    right.discards = left.discards;
+    if (job->combineHalves != NULL)
     {
-        connectNode(tree, NULL, *parentP, toDeleteSide);
+        job->combineHalves(&left, &right);
     }
-    else if ((*toDeleteP)->color == BLACK)
+    else
     {
-        *childP = getSingleChild((*toDeleteP));
-        connectNode(tree, *childP, *parentP, toDeleteSide);
-        if (*childP != NULL && (*childP)->color == RED)
-        {
-            (*childP)->color = BLACK;
-        }
-        else
-        {
-            solveDB(tree, parentP, childP, toDeleteSide);
-        }
+        RBTreeCombineNodes(&left);
+        RBTreeCombineNodes(&right);
     }
+    appendDiscards(&job->discards, &left.discards);
+    appendDiscards(&job->discards, &right.discards);
+    if (job->operation == UNITE || (job->operation == INTERSECT) == (found != NULL))
+    {
+        job->result = joinNodes(job->tree, left.result, left.height, a, right.result, right.height, &job->height);
+        return;
+    }
+    *a = (Node) {.parentColor = (uintptr_t) BLACK, .left = NULL, .right = NULL, .data = a->data};
+    discardSubtree(a, &job->discards);
+    job->result = concatNodes(job->tree, left.result, left.height, right.result, right.height, &job->height);
 }
 
 /**
- * remove an item from the tree
- * @param tree: the tree to remove an item from.
- * @param data: item to remove from the tree.
- * @return: 0 on failure, other on success. (if data is not in the tree - failure).
+ * @brief Combines the items of other into tree by a set operation and frees other.
+ * @param tree The tree to hold the result.
+ * @param other The second tree, freed and set to NULL on success.
+ * @param operation UNITE, INTERSECT or SUBTRACT.
+ * @param combineHalves Combines the two halves of every step, NULL to combine them one after the other.
+ * @param context The context of combineHalves.
+ * @return 1 on success, 0 on failure (both trees are not changed).
  */
-int deleteFromRBTree(RBTree *tree, void *data)
+int combineRBTrees(RBTree *tree, RBTree **other, int operation, CombineHalvesFunc combineHalves, void *context)
 {
-    if (tree == NULL)
-    {
-        return FAILURE;
-    }
-    Node *toDelete = findNode(tree, data);
-    Node *child = NULL;
-    if (!placeBeforeDeletion(tree, toDelete, &child))
+    if (tree == NULL || other == NULL || *other == NULL || !canShareNodes(tree, *other))
     {
         return FAILURE;
     }
-    Node *parent = toDelete->parent;
-    int toDeleteSide = getSide(toDelete);
-    balanceTree(tree, &parent, &toDelete, &child, toDeleteSide);
-    toDelete->right = NULL, toDelete->left = NULL;
-    freeNode(tree, toDelete);
-    (tree->size)--;
+    CombineJob job = {.tree = tree, .combineHalves = combineHalves, .context = context, .operation = operation,
+                      .a = tree->root, .aHeight = blackHeight(tree->root), .b = (*other)->root,
+                      .bHeight = blackHeight((*other)->root), .discards = {.first = NULL, .last = NULL}};
+    long unsigned amount = tree->size + (*other)->size;
+    RBTreeCombineNodes(&job);
+    tree->root = job.result;
+    tree->size = amount - freeDiscards(tree, &job.discards);
+    (*other)->root = NULL;
+    freeRBTree(other);
     return SUCCESS;
 }
 
-
 /**
- * check whether the tree RBTreeContains this item.
- * @param tree: the tree to add an item to.
- * @param data: item to check.
- * @return: 0 if the item is not in the tree, other if it is.
+ * move the items of other that are not in tree into tree, in O(m log(n/m + 1)) for trees of m <= n items. items of
+ * other that equal items of tree are freed with the free function of tree.
+ * @param tree: the tree to hold the union.
+ * @param other: a tree made by newRBTreeLike(tree) or sharing its nodes. freed and set to NULL on success.
+ * @return: 1 on success, 0 on failure (the trees can not share nodes, neither tree is changed).
  */
-int RBTreeContains(const RBTree *tree, const void *data)
+int unionRBTree(RBTree *tree, RBTree **other)
 {
-    if (tree == NULL)
-    {
-        return FAILURE;
-    }
-    return (findNode(tree, data) != NULL);
+    return combineRBTrees(tree, other, UNITE, NULL, NULL);
 }
 
 /**
- * Activate a function on each item of the sub-tree whose root is node. The order is an ascending order. if one of the activations of the
- * function returns 0, the process stops.
- * @param node The root of the sub-tree to check.
- * @param func: the function to activate on all items.
- * @param args: more optional arguments to the function (may be null if the given function support it).
- * @return: 0 on failure, 1 on success.
+ * keep only the items of tree that are also in other, in O(m log(n/m + 1)) for trees of m <= n items. all the items
+ * of other and the removed items of tree are freed with the free function of tree.
+ * @param tree: the tree to hold the intersection.
+ * @param other: a tree made by newRBTreeLike(tree) or sharing its nodes. freed and set to NULL on success.
+ * @return: 1 on success, 0 on failure (the trees can not share nodes, neither tree is changed).
  */
-int forEachNode(const Node *node, forEachFunc func, void *args)
+int intersectRBTree(RBTree *tree, RBTree **other)
 {
-    if (node == NULL)
-    {
-        return SUCCESS;
-    }
-    if (forEachNode(node->left, func, args) == FAILURE)
-    {
-        return FAILURE;
-    }
-    if (func(node->data, args) == FAILURE)
-    {
-        return FAILURE;
-    }
-    if (forEachNode(node->right, func, args) == FAILURE)
-    {
-        return FAILURE;
-    }
-    return SUCCESS;
+    return combineRBTrees(tree, other, INTERSECT, NULL, NULL);
 }
 
 /**
- * Activate a function on each item of the tree. the order is an ascending order. if one of the activations of the
- * function returns 0, the process stops.
- * @param tree: the tree with all the items.
- * @param func: the function to activate on all items.
- * @param args: more optional arguments to the function (may be null if the given function support it).
- * @return: 0 on failure, other on success.
+ * remove the items of other from tree, in O(m log(n/m + 1)) for trees of m <= n items. all the items of other and
+ * the removed items of tree are freed with the free function of tree.
+ * @param tree: the tree to hold the difference.
+ * @param other: a tree made by newRBTreeLike(tree) or sharing its nodes. freed and set to NULL on success.
+ * @return: 1 on success, 0 on failure (the trees can not share nodes, neither tree is changed).
  */
-int forEachRBTree(const RBTree *tree, forEachFunc func, void *args)
+int subtractRBTree(RBTree *tree, RBTree **other)
 {
-    if (tree == NULL)
-    {
-        return FAILURE;
-    }
-    if (tree->root == NULL)
-    {
-        return SUCCESS;
-    }
-    return forEachNode(tree->root, func, args);
+    return combineRBTrees(tree, other, SUBTRACT, NULL, NULL);
 }
 
 /**
@@ -704,8 +2147,34 @@ int forEachRBTree(const RBTree *tree, forEachFunc func, void *args)
  */
 void freeRBTree(RBTree **tree)
 {
-    Node *root = (*tree)->root;
-    freeNode(*tree, root);
+    NodePool *pool = (*tree)->pool;
+    int lastUser = FAILURE;
+    if (pool != NULL)
+    {
+        // no other tree can join the pool while this one is its only user, and otherwise the items must be freed
+        // before leaving it, since the last user frees the slabs they are in.
+        pthread_mutex_lock(&pool->lock);
+        lastUser = pool->users == 1;
+        pthread_mutex_unlock(&pool->lock);
+    }
+    if (lastUser)
+    {
+        freePool(*tree);
+    }
+    else
+    {
+        freeNode(*tree, (*tree)->root);
+        if (pool != NULL && leavePool(*tree))
+        {
+            freePool(*tree);
+        }
+    }
+    if ((*tree)->owned != NULL && atomic_fetch_sub(&(*tree)->owned->users, 1) == 1)
+    {
+        ((*tree)->owned->freeFunc)((*tree)->owned->resource);
+        free((*tree)->owned);
+    }
+    free((*tree)->augmentations);
     free(*tree);
     *tree = NULL;
 }
@@ -1,6 +1,9 @@
 #ifndef RBTREE_RBTREE_H
 #define RBTREE_RBTREE_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 // a color of a Node.
 typedef enum Color
 {
@@ -28,16 +31,86 @@ typedef int (*forEachFunc)(const void *object, void *args);
  */
 typedef void (*FreeFunc)(void *data);
 
+/**
+ * a function to compute what a tree keeps next to an item, so walks can read it instead of recomputing it.
+ * @object: a pointer to an item of the tree.
+ * @cache: where to write the cache of the item, of the cacheSize of the tree.
+ */
+typedef void (*CacheFunc)(const void *object, void *cache);
+
+/**
+ * a function to map an item to a number that sorts like it, so searches can compare numbers kept in the nodes and
+ * call the CompareFunc only when they are equal.
+ * @object: a pointer to an item of the tree.
+ * @return: the prefix of the item. if a is smaller than b by the CompareFunc, the prefix of a must not be greater
+ * than that of b (so equal items have equal prefixes).
+ */
+typedef uint64_t (*PrefixFunc)(const void *object);
+
+/**
+ * a function to summarize one item, as the summary of a sub-tree that holds only that item.
+ * @summary: where to write the summary, of the summarySize of the augmentation.
+ * @object: a pointer to an item of the tree.
+ * @cache: the cache of the item, NULL if the tree keeps none.
+ */
+typedef void (*SummarizeFunc)(void *summary, const void *object, const void *cache);
+
+/**
+ * a function to merge the summaries of two adjacent ranges of items into the summary of both.
+ * @result: where to write the merged summary. it may be the same as first or second.
+ * @first: the summary of the range of smaller items.
+ * @second: the summary of the range of greater items.
+ */
+typedef void (*MergeFunc)(void *result, const void *first, const void *second);
+
+/**
+ * a summary that every node of a tree keeps about its sub-tree (its size, the sum, min or max of some field of the
+ * items...). the summaries are kept up to date on every change of the tree, so the summary of the whole tree is
+ * O(1) to get and that of a range O(log n).
+ */
+typedef struct RBTreeAugmentation
+{
+	size_t summarySize; // bytes of a summary.
+	SummarizeFunc summarizeFunc;
+	MergeFunc mergeFunc;
+	size_t offset; // where a node keeps the summary, set by the tree.
+} RBTreeAugmentation;
+
 /*
- * a node of the tree.
+ * a node of the tree. nodes are at least 2-aligned, so the color is kept in the lowest bit of the parent pointer
+ * and a node takes 4 words (32 bytes on 64 bit machines).
+ * this breaks code that read the parent and color fields of the earlier layout: node->parent is now getParent(node)
+ * and node->color is getColor(node). the left, right and data fields are unchanged.
  */
 typedef struct Node
 {
-	struct Node *parent, *left, *right;
-	Color color;
+	uintptr_t parentColor;
+	struct Node *left, *right;
 	void *data;
 } Node;
 
+/**
+ * a pool the nodes of a tree are allocated from (defined in RBTree.c).
+ */
+struct NodePool;
+
+/**
+ * a chunk of nodes of a pool (defined in RBTree.c).
+ */
+struct Slab;
+
+/**
+ * @param node: a node of a tree.
+ * @return: the parent of node, NULL for the root.
+ */
+Node *getParent(const Node *node);
+
+/**
+ * @param node: a node of a tree.
+ * @return: the color of node.
+ */
+Color getColor(const Node *node);
+
 /**
  * represents the tree
  */
@@ -47,14 +120,98 @@ typedef struct RBTree
 	CompareFunc compFunc;
 	FreeFunc freeFunc;
 	long unsigned size;
+	struct NodePool *pool;
+	Node *freeNodes; // pool nodes this tree released, reused by it before it turns to the pool.
+	struct Slab *slab; // the slab of the pool this tree takes new nodes from, NULL if it took none yet.
+	size_t nodeSize; // the bytes of a node, including the optional fields kept after it.
+	size_t countOffset; // where a node keeps the size of its sub-tree, 0 if it does not.
+	CacheFunc cacheFunc;
+	size_t cacheOffset; // where a node keeps the cache of its item, 0 if it does not.
+	PrefixFunc prefixFunc;
+	size_t prefixOffset; // where a node keeps the prefix of its item, 0 if it does not.
+	RBTreeAugmentation *augmentations; // a copy of the augmentations of the options, with their offsets.
+	int augmentationsAmount;
+	struct OwnedResource *owned; // what the tree frees after its items, shared by the trees made like it.
 } RBTree;
 
+/**
+ * a position in a tree, for walking over its items in order. the end position lies between the last item and the
+ * first one. an iterator stays valid as long as the tree is not changed.
+ */
+typedef struct RBTreeIterator
+{
+	const RBTree *tree;
+	Node *node;
+} RBTreeIterator;
+
+/**
+ * optional features of a tree, chosen when the tree is constructed.
+ */
+typedef struct RBTreeOptions
+{
+	// amount of nodes allocated together in one slab, 0 to allocate every node on its own. a tree whose slabs would
+	// be too large for a size_t is not constructed.
+	long unsigned poolSlabNodes;
+	// whether every node keeps the size of its sub-tree, making RBTreeRank and RBTreeSelect O(log n). splitRBTree
+	// needs it.
+	int orderStatistics;
+	// a number every node keeps for its item, that searches compare before calling the CompareFunc. NULL to keep
+	// none. every search of the tree by a key compares it: inserts, deletes, lookups, bounds, ranges, ranks, split
+	// and the set operations. only item to item comparisons call the CompareFunc directly: the sort and duplicate
+	// checks of insertManyToRBTree and fillRBTreeFromSorted, and the order checks of joinRBTree.
+	PrefixFunc prefixFunc;
+	// bytes every node keeps for its item, filled by cacheFunc when the item is added. 0 to keep nothing.
+	size_t cacheSize;
+	CacheFunc cacheFunc;
+	// the summaries every node keeps about its sub-tree, RBTreeSummary and RBTreeRangeSummary get them by their
+	// index in this array. the array is copied, NULL (and an amount of 0) to keep none.
+	const RBTreeAugmentation *augmentations;
+	int augmentationsAmount;
+} RBTreeOptions;
+
 /**
  * constructs a new RBTree with the given CompareFunc.
  * comp: a function two compare two variables.
  */
 RBTree *newRBTree(CompareFunc compFunc, FreeFunc freeFunc); // implement it in RBTree.c
 
+/**
+ * constructs a new RBTree with the given CompareFunc and optional features.
+ * @param compFunc: a function two compare two variables.
+ * @param freeFunc: a function to free an item of the tree, NULL if the items are not freed one by one (e.g. they are
+ * stored in a resource the tree owns).
+ * @param options: the features of the tree, NULL for the defaults of newRBTree.
+ * @return: the new tree, NULL on failure.
+ */
+RBTree *newRBTreeWithOptions(CompareFunc compFunc, FreeFunc freeFunc, const RBTreeOptions *options);
+
+/**
+ * constructs an empty tree with the functions and features of another tree. the two trees share the node pool, so
+ * they can exchange nodes with joinRBTree. trees that share a pool can be changed and freed by different threads at
+ * once (every tree keeps its own released nodes and slab, and locks the pool only to take a new slab or the nodes
+ * freed trees gave back), but one tree must not be used by two threads at once.
+ * @param tree: the tree to copy the setup of.
+ * @return: the new tree, NULL on failure.
+ */
+RBTree *newRBTreeLike(const RBTree *tree);
+
+/**
+ * give a tree a resource to free after its items, like an arena that stores them. the trees made like the tree share
+ * the resource, and it is freed with the last of them.
+ * @param tree: a tree that owns nothing yet.
+ * @param resource: the resource.
+ * @param freeResource: a function to free the resource.
+ * @return: 0 on failure, other on success. (if the tree already owns a resource - failure, and the new resource stays
+ * owned by the caller).
+ */
+int ownRBTreeResource(RBTree *tree, void *resource, FreeFunc freeResource);
+
+/**
+ * @param tree: a tree.
+ * @return: the resource the tree owns, NULL if it owns none.
+ */
+void *RBTreeResource(const RBTree *tree);
+
 /**
  * add an item to the tree
  * @param tree: the tree to add an item to.
@@ -63,6 +220,29 @@ RBTree *newRBTree(CompareFunc compFunc, FreeFunc freeFunc); // implement it in R
  */
 int insertToRBTree(RBTree *tree, void *data); // implement it in RBTree.c
 
+/**
+ * fill an empty tree with sorted items in linear time, without rebalancing.
+ * @param tree: an empty tree.
+ * @param items: the items, in ascending order of the CompareFunc of the tree and without duplicates.
+ * @param amount: the amount of items.
+ * @return: 0 on failure, other on success. (if the tree is not empty or the items are not strictly ascending -
+ * failure, and the tree is left empty).
+ */
+int fillRBTreeFromSorted(RBTree *tree, void *const *items, long unsigned amount);
+
+/**
+ * add a batch of items to the tree. the batch is sorted and merged in ascending order, each insertion searching from
+ * the previous one instead of from the root.
+ * @param tree: the tree to add the items to.
+ * @param items: the items to add. they are reordered: the first (new size - old size) of them are the inserted
+ * items in ascending order, and the rest are the items that were already in the tree or repeated in the batch, which
+ * stay owned by the caller.
+ * @param amount: the amount of items.
+ * @return: 0 on failure, other on success. (if an item is NULL or an allocation fails - failure, and the tree is not
+ * changed).
+ */
+int insertManyToRBTree(RBTree *tree, void **items, long unsigned amount);
+
 /**
  * remove an item from the tree
  * @param tree: the tree to remove an item from.
@@ -79,6 +259,15 @@ int deleteFromRBTree(RBTree *tree, void *data); // implement it in RBTree.c
  */
 int RBTreeContains(const RBTree *tree, const void *data); // implement it in RBTree.c
 
+/**
+ * recompute what the tree keeps for an item after the item changed. the change must not move the item in the order
+ * of the tree.
+ * @param tree: the tree that holds the item.
+ * @param data: the item that changed, or an item equal to it.
+ * @return: 0 on failure, other on success. (if data is not in the tree - failure).
+ */
+int refreshRBTreeItem(RBTree *tree, const void *data);
+
 
 
 /**
@@ -91,6 +280,181 @@ int RBTreeContains(const RBTree *tree, const void *data); // implement it in RBT
  */
 int forEachRBTree(const RBTree *tree, forEachFunc func, void *args); // implement it in RBTree.c
 
+/**
+ * Activate a function on each item of the tree between lo and hi (both included). the order is an ascending order.
+ * if one of the activations of the function returns 0, the process stops. only the nodes on the paths to the range
+ * and inside it are visited.
+ * @param tree: the tree with all the items.
+ * @param lo: the smallest key of the range (it does not have to be in the tree).
+ * @param hi: the greatest key of the range (it does not have to be in the tree).
+ * @param func: the function to activate on the items.
+ * @param args: more optional arguments to the function (may be null if the given function support it).
+ * @return: 0 on failure, other on success.
+ */
+int forEachRBTreeInRange(const RBTree *tree, const void *lo, const void *hi, forEachFunc func, void *args);
+
+/**
+ * get the summary of all the items of a tree for one of its augmentations, in O(1).
+ * @param tree: a tree constructed with augmentations.
+ * @param augmentation: the index of the augmentation in the options of the tree.
+ * @return: the summary, NULL if the tree is empty or has no such augmentation. it is valid until the tree changes.
+ */
+const void *RBTreeSummary(const RBTree *tree, int augmentation);
+
+/**
+ * get the summary of the items of a tree between lo and hi (both included) for one of its augmentations, in
+ * O(log n). the range is covered by the summaries of O(log n) sub-trees and items, merged in order.
+ * @param tree: a tree constructed with augmentations.
+ * @param augmentation: the index of the augmentation in the options of the tree.
+ * @param lo: the smallest key of the range (it does not have to be in the tree).
+ * @param hi: the greatest key of the range (it does not have to be in the tree).
+ * @param summary: receives the summary, of the summarySize of the augmentation.
+ * @return: 0 on failure, other on success. (if the range has no items or the tree has no such augmentation -
+ * failure).
+ */
+int RBTreeRangeSummary(const RBTree *tree, int augmentation, const void *lo, const void *hi, void *summary);
+
+/**
+ * count the items of the tree that are smaller than data. O(log n) if the tree keeps order statistics, otherwise the
+ * smaller items are walked over.
+ * @param tree: the tree to count in.
+ * @param data: the key to compare the items with (it does not have to be in the tree).
+ * @return: the amount of items smaller than data, which is the index of data if it is in the tree.
+ */
+long unsigned RBTreeRank(const RBTree *tree, const void *data);
+
+/**
+ * find the item at an index of the ascending order. O(log n) if the tree keeps order statistics, otherwise the
+ * preceding items are walked over.
+ * @param tree: the tree to search.
+ * @param index: the amount of items smaller than the wanted one.
+ * @return: the item, NULL if index is not smaller than the size of the tree.
+ */
+void *RBTreeSelect(const RBTree *tree, long unsigned index);
+
+/**
+ * move the items of a tree that are greater than or equal to key into a new tree, in O(log n). the new tree is made
+ * by newRBTreeLike. the tree must keep order statistics, which give the sizes of both trees in O(1). the two trees
+ * share the node pool, and can be changed by different threads at once (see newRBTreeLike).
+ * @param tree: the tree to split, keeps the items smaller than key.
+ * @param key: the key to split by (it does not have to be in the tree).
+ * @return: the tree of the items greater than or equal to key, NULL on failure (if the tree keeps no order
+ * statistics or an allocation fails - failure, and the tree is not changed).
+ */
+RBTree *splitRBTree(RBTree *tree, const void *key);
+
+/**
+ * move pivot and all the items of another tree into a tree, in O(log n). all the items of tree must be smaller than
+ * pivot, and pivot smaller than all the items of other. the trees must share nodes (see newRBTreeLike), and neither
+ * may be in use by another thread while they are joined.
+ * @param tree: the tree of the small items, receives all the items.
+ * @param pivot: an item between the items of the two trees, may be NULL to only concatenate the trees.
+ * @param other: pointer to the tree of the great items, freed on success.
+ * @return: 0 on failure, other on success. (if the items are not in order or the trees do not share nodes - failure,
+ * and the trees are not changed).
+ */
+int joinRBTree(RBTree *tree, void *pivot, RBTree **other);
+
+/**
+ * move the items of other that are not in tree into tree, in O(m log(n/m + 1)) for trees of m <= n items. items of
+ * other that equal items of tree are freed with the free function of tree.
+ * @param tree: the tree to hold the union.
+ * @param other: a tree made by newRBTreeLike(tree) or sharing its nodes. freed and set to NULL on success.
+ * @return: 1 on success, 0 on failure (the trees can not share nodes, neither tree is changed).
+ */
+int unionRBTree(RBTree *tree, RBTree **other);
+
+/**
+ * keep only the items of tree that are also in other, in O(m log(n/m + 1)) for trees of m <= n items. all the items
+ * of other and the removed items of tree are freed with the free function of tree.
+ * @param tree: the tree to hold the intersection.
+ * @param other: a tree made by newRBTreeLike(tree) or sharing its nodes. freed and set to NULL on success.
+ * @return: 1 on success, 0 on failure (the trees can not share nodes, neither tree is changed).
+ */
+int intersectRBTree(RBTree *tree, RBTree **other);
+
+/**
+ * remove the items of other from tree, in O(m log(n/m + 1)) for trees of m <= n items. all the items of other and
+ * the removed items of tree are freed with the free function of tree.
+ * @param tree: the tree to hold the difference.
+ * @param other: a tree made by newRBTreeLike(tree) or sharing its nodes. freed and set to NULL on success.
+ * @return: 1 on success, 0 on failure (the trees can not share nodes, neither tree is changed).
+ */
+int subtractRBTree(RBTree *tree, RBTree **other);
+
+/**
+ * move an iterator to the first item of a tree.
+ * @param tree: the tree to walk over.
+ * @param iter: the iterator to set.
+ * @return: the first item, NULL if the tree is empty.
+ */
+void *RBTreeFirst(const RBTree *tree, RBTreeIterator *iter);
+
+/**
+ * move an iterator to the last item of a tree.
+ * @param tree: the tree to walk over.
+ * @param iter: the iterator to set.
+ * @return: the last item, NULL if the tree is empty.
+ */
+void *RBTreeLast(const RBTree *tree, RBTreeIterator *iter);
+
+/**
+ * move an iterator to the next item in ascending order. from the end it moves to the first item.
+ * @param iter: the iterator to move.
+ * @return: the next item, NULL if the iterator passed the last item.
+ */
+void *RBTreeNext(RBTreeIterator *iter);
+
+/**
+ * move an iterator to the previous item in ascending order. from the end it moves to the last item.
+ * @param iter: the iterator to move.
+ * @return: the previous item, NULL if the iterator passed the first item.
+ */
+void *RBTreePrev(RBTreeIterator *iter);
+
+/**
+ * get the cache the tree keeps for the item at an iterator.
+ * @param iter: an iterator of a tree constructed with a cacheFunc.
+ * @return: the cache of the item, NULL at the end position or if the tree keeps no cache.
+ */
+const void *RBTreeCache(const RBTreeIterator *iter);
+
+/**
+ * find the first item that is not smaller than key.
+ * @param tree: the tree to search.
+ * @param key: the key to compare the items with (it does not have to be in the tree).
+ * @param iter: an iterator to place on the found item or on the end, may be NULL.
+ * @return: the found item, NULL if there is none.
+ */
+void *RBTreeLowerBound(const RBTree *tree, const void *key, RBTreeIterator *iter);
+
+/**
+ * find the first item that is greater than key.
+ * @param tree: the tree to search.
+ * @param key: the key to compare the items with (it does not have to be in the tree).
+ * @param iter: an iterator to place on the found item or on the end, may be NULL.
+ * @return: the found item, NULL if there is none.
+ */
+void *RBTreeUpperBound(const RBTree *tree, const void *key, RBTreeIterator *iter);
+
+/**
+ * find the greatest item that is smaller than or equal to key.
+ * @param tree: the tree to search.
+ * @param key: the key to compare the items with (it does not have to be in the tree).
+ * @param iter: an iterator to place on the found item or on the end, may be NULL.
+ * @return: the found item, NULL if there is none.
+ */
+void *RBTreeFloor(const RBTree *tree, const void *key, RBTreeIterator *iter);
+
+/**
+ * find the smallest item that is greater than or equal to key (the same item as RBTreeLowerBound).
+ * @param tree: the tree to search.
+ * @param key: the key to compare the items with (it does not have to be in the tree).
+ * @param iter: an iterator to place on the found item or on the end, may be NULL.
+ * @return: the found item, NULL if there is none.
+ */
+void *RBTreeCeiling(const RBTree *tree, const void *key, RBTreeIterator *iter);
+
 /**
  * free all memory of the data structure.
  * @param tree: pointer to the tree to free.
@@ -0,0 +1,197 @@
+#ifndef RBTREE_RBTREEFIXUPS_H
+#define RBTREE_RBTREEFIXUPS_H
+
+#include "RBTree.h"
+
+/*
+ * generates the rotations and the fix-ups of the red black rules after an insertion or a removal, for trees whose
+ * nodes link to each other in different ways (pointers in RBTree.c, indices in ArenaRBTree.c), so there is one copy
+ * of them.
+ *
+ * RBTREE_DEFINE_FIXUPS(suffix, TreeType, NodeRef, NIL, ACCESS) defines, as static functions of one source file:
+ * void replaceNode##suffix(TreeType *tree, NodeRef oldNode, NodeRef newNode): puts newNode (may be NIL) in the place
+ * of oldNode under the parent of oldNode.
+ * void rotate##suffix(TreeType *tree, NodeRef child, NodeRef parent): rotates the sub-tree of parent so that child,
+ * one of its children, becomes its root.
+ * void fixInsertion##suffix(TreeType *tree, NodeRef node): restores the rules after a red node was linked as a leaf.
+ * the root may be left red.
+ * void fixDeletion##suffix(TreeType *tree, NodeRef child, NodeRef parent): solves a double black at child (may be
+ * NIL), the child of parent, walking up the tree until it is absorbed.
+ * void removeNode##suffix(TreeType *tree, NodeRef toRemove): unlinks a node and rebalances the tree. a node with two
+ * children is replaced by its successor node, so the other nodes keep their data.
+ * suffix may be empty. TreeType must have a NodeRef root field, NIL if the tree is empty. NodeRef is the type that
+ * refers to a node, and NIL refers to no node.
+ *
+ * the nodes are read and changed through macros whose names start with ACCESS:
+ * ACCESS##_PARENT(tree, node): the parent of node, NIL for the root.
+ * ACCESS##_SET_PARENT(tree, node, parent): sets the parent of node (not NIL), keeping its color.
+ * ACCESS##_LEFT(tree, node), ACCESS##_RIGHT(tree, node): the children of node (not NIL), as assignable expressions.
+ * ACCESS##_IS_RED(tree, node): whether node is red, false for NIL.
+ * ACCESS##_COLOR(tree, node), ACCESS##_SET_COLOR(tree, node, color): the color of node (not NIL).
+ * ACCESS##_ROTATED(tree, parent, child): called after a rotation made parent the child of child.
+ * ACCESS##_UNLINKED(tree, parent): called after a node was unlinked, before the fix-up, with the lowest node whose
+ * sub-tree lost it (NIL if it was the only node).
+ */
+#define RBTREE_DEFINE_FIXUPS(suffix, TreeType, NodeRef, NIL, ACCESS) \
+	static void replaceNode##suffix(TreeType *tree, NodeRef oldNode, NodeRef newNode) \
+	{ \
+		NodeRef parent = ACCESS##_PARENT(tree, oldNode); \
+		if (parent == NIL) \
+		{ \
+			tree->root = newNode; \
+		} \
+		else if (ACCESS##_LEFT(tree, parent) == oldNode) \
+		{ \
+			ACCESS##_LEFT(tree, parent) = newNode; \
+		} \
+		else \
+		{ \
+			ACCESS##_RIGHT(tree, parent) = newNode; \
+		} \
+		if (newNode != NIL) \
+		{ \
+			ACCESS##_SET_PARENT(tree, newNode, parent); \
+		} \
+	} \
+	\
+	static void rotate##suffix(TreeType *tree, NodeRef child, NodeRef parent) \
+	{ \
+		NodeRef moved; \
+		replaceNode##suffix(tree, parent, child); \
+		if (child == ACCESS##_LEFT(tree, parent)) \
+		{ \
+			moved = ACCESS##_RIGHT(tree, child); \
+			ACCESS##_LEFT(tree, parent) = moved; \
+			ACCESS##_RIGHT(tree, child) = parent; \
+		} \
+		else \
+		{ \
+			moved = ACCESS##_LEFT(tree, child); \
+			ACCESS##_RIGHT(tree, parent) = moved; \
+			ACCESS##_LEFT(tree, child) = parent; \
+		} \
+		if (moved != NIL) \
+		{ \
+			ACCESS##_SET_PARENT(tree, moved, parent); \
+		} \
+		ACCESS##_SET_PARENT(tree, parent, child); \
+		ACCESS##_ROTATED(tree, parent, child); \
+	} \
+	\
+	static void fixInsertion##suffix(TreeType *tree, NodeRef node) \
+	{ \
+		NodeRef parent; \
+		while ((parent = ACCESS##_PARENT(tree, node)) != NIL && ACCESS##_IS_RED(tree, parent)) \
+		{ \
+			/* a red parent is never the root, so the grand parent exists. */ \
+			NodeRef gParent = ACCESS##_PARENT(tree, parent); \
+			int parentIsLeft = (parent == ACCESS##_LEFT(tree, gParent)); \
+			NodeRef uncle = parentIsLeft ? ACCESS##_RIGHT(tree, gParent) : ACCESS##_LEFT(tree, gParent); \
+			if (ACCESS##_IS_RED(tree, uncle)) \
+			{ \
+				ACCESS##_SET_COLOR(tree, parent, BLACK); \
+				ACCESS##_SET_COLOR(tree, uncle, BLACK); \
+				ACCESS##_SET_COLOR(tree, gParent, RED); \
+				node = gParent; \
+				continue; \
+			} \
+			if ((node == ACCESS##_LEFT(tree, parent)) != parentIsLeft) \
+			{ \
+				rotate##suffix(tree, node, parent); \
+				parent = node; \
+			} \
+			rotate##suffix(tree, parent, gParent); \
+			ACCESS##_SET_COLOR(tree, parent, BLACK); \
+			ACCESS##_SET_COLOR(tree, gParent, RED); \
+			break; \
+		} \
+	} \
+	\
+	static void fixDeletion##suffix(TreeType *tree, NodeRef child, NodeRef parent) \
+	{ \
+		while (child != tree->root && !ACCESS##_IS_RED(tree, child)) \
+		{ \
+			int childIsLeft = (child == ACCESS##_LEFT(tree, parent)); \
+			NodeRef sibling = childIsLeft ? ACCESS##_RIGHT(tree, parent) : ACCESS##_LEFT(tree, parent); \
+			if (ACCESS##_IS_RED(tree, sibling)) \
+			{ \
+				ACCESS##_SET_COLOR(tree, sibling, BLACK); \
+				ACCESS##_SET_COLOR(tree, parent, RED); \
+				rotate##suffix(tree, sibling, parent); \
+				sibling = childIsLeft ? ACCESS##_RIGHT(tree, parent) : ACCESS##_LEFT(tree, parent); \
+			} \
+			NodeRef closeNephew = childIsLeft ? ACCESS##_LEFT(tree, sibling) : ACCESS##_RIGHT(tree, sibling); \
+			NodeRef farNephew = childIsLeft ? ACCESS##_RIGHT(tree, sibling) : ACCESS##_LEFT(tree, sibling); \
+			if (!ACCESS##_IS_RED(tree, closeNephew) && !ACCESS##_IS_RED(tree, farNephew)) \
+			{ \
+				ACCESS##_SET_COLOR(tree, sibling, RED); \
+				child = parent; \
+				parent = ACCESS##_PARENT(tree, child); \
+				continue; \
+			} \
+			if (!ACCESS##_IS_RED(tree, farNephew)) \
+			{ \
+				ACCESS##_SET_COLOR(tree, closeNephew, BLACK); \
+				ACCESS##_SET_COLOR(tree, sibling, RED); \
+				rotate##suffix(tree, closeNephew, sibling); \
+				farNephew = sibling; \
+				sibling = closeNephew; \
+			} \
+			ACCESS##_SET_COLOR(tree, sibling, ACCESS##_COLOR(tree, parent)); \
+			ACCESS##_SET_COLOR(tree, parent, BLACK); \
+			ACCESS##_SET_COLOR(tree, farNephew, BLACK); \
+			rotate##suffix(tree, sibling, parent); \
+			return; \
+		} \
+		if (child != NIL) \
+		{ \
+			ACCESS##_SET_COLOR(tree, child, BLACK); \
+		} \
+	} \
+	\
+	static void removeNode##suffix(TreeType *tree, NodeRef toRemove) \
+	{ \
+		NodeRef child; \
+		NodeRef parent; \
+		Color removedColor = ACCESS##_COLOR(tree, toRemove); \
+		if (ACCESS##_LEFT(tree, toRemove) == NIL || ACCESS##_RIGHT(tree, toRemove) == NIL) \
+		{ \
+			child = ACCESS##_LEFT(tree, toRemove) != NIL ? ACCESS##_LEFT(tree, toRemove) : \
+			        ACCESS##_RIGHT(tree, toRemove); \
+			parent = ACCESS##_PARENT(tree, toRemove); \
+			replaceNode##suffix(tree, toRemove, child); \
+		} \
+		else \
+		{ \
+			NodeRef suc = ACCESS##_RIGHT(tree, toRemove); \
+			while (ACCESS##_LEFT(tree, suc) != NIL) \
+			{ \
+				suc = ACCESS##_LEFT(tree, suc); \
+			} \
+			removedColor = ACCESS##_COLOR(tree, suc); \
+			child = ACCESS##_RIGHT(tree, suc); \
+			if (ACCESS##_PARENT(tree, suc) == toRemove) \
+			{ \
+				parent = suc; \
+			} \
+			else \
+			{ \
+				parent = ACCESS##_PARENT(tree, suc); \
+				replaceNode##suffix(tree, suc, child); \
+				ACCESS##_RIGHT(tree, suc) = ACCESS##_RIGHT(tree, toRemove); \
+				ACCESS##_SET_PARENT(tree, ACCESS##_RIGHT(tree, suc), suc); \
+			} \
+			replaceNode##suffix(tree, toRemove, suc); \
+			ACCESS##_LEFT(tree, suc) = ACCESS##_LEFT(tree, toRemove); \
+			ACCESS##_SET_PARENT(tree, ACCESS##_LEFT(tree, suc), suc); \
+			ACCESS##_SET_COLOR(tree, suc, ACCESS##_COLOR(tree, toRemove)); \
+		} \
+		ACCESS##_UNLINKED(tree, parent); \
+		if (removedColor == BLACK) \
+		{ \
+			fixDeletion##suffix(tree, child, parent); \
+		} \
+	}
+
+
+#endif //RBTREE_RBTREEFIXUPS_H
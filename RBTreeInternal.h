@@ -0,0 +1,82 @@
+#ifndef RBTREE_RBTREEINTERNAL_H
+#define RBTREE_RBTREEINTERNAL_H
+
+#include "RBTreeNodes.h"
+
+/*
+ * the parts of RBTree.c that the other source files of the library are built from, besides those of RBTreeNodes.h.
+ * RBTree.c includes this header too, so the declarations can not drift from the definitions. users of the library
+ * should not need it, and no public header includes it.
+ */
+
+// the set operations of combineRBTrees.
+#define UNITE (0)
+#define INTERSECT (1)
+#define SUBTRACT (2)
+
+/**
+ * sub-trees put aside by a set operation, chained through the parent field of their roots.
+ */
+typedef struct Discards
+{
+	Node *first, *last;
+} Discards;
+
+/**
+ * a step of a set operation: combining two sub-trees into one.
+ */
+typedef struct CombineJob
+{
+	const RBTree *tree;
+	// combines the two halves of a step (e.g. in parallel) with RBTreeCombineNodes, NULL to combine them in order.
+	void (*combineHalves)(struct CombineJob *left, struct CombineJob *right);
+	void *context; // for combineHalves.
+	int operation;
+	Node *a, *b;
+	int aHeight, bHeight;
+	Discards discards;
+	Node *result;
+	int height;
+} CombineJob;
+
+typedef void (*CombineHalvesFunc)(CombineJob *left, CombineJob *right);
+
+/**
+ * combines two sub-trees by a set operation.
+ * @param job: the sub-trees to combine, receives the result.
+ */
+void RBTreeCombineNodes(CombineJob *job);
+
+/**
+ * combines the items of other into tree by a set operation and frees other.
+ * @param tree: the tree to hold the result.
+ * @param other: the second tree, freed and set to NULL on success.
+ * @param operation: UNITE, INTERSECT or SUBTRACT.
+ * @param combineHalves: combines the two halves of every step, NULL to combine them one after the other.
+ * @param context: the context of combineHalves.
+ * @return: 1 on success, 0 on failure (both trees are not changed).
+ */
+int combineRBTrees(RBTree *tree, RBTree **other, int operation, CombineHalvesFunc combineHalves, void *context);
+
+/**
+ * @param node: the root of a non empty sub-tree.
+ * @return: the node of the sub-tree with the smallest item.
+ */
+Node *RBTreeLeftmost(Node *node);
+
+/**
+ * @param tree: the tree of node.
+ * @param node: a node, may be NULL.
+ * @return: the amount of items in the sub-tree of node. the tree must keep order statistics.
+ */
+long unsigned RBTreeSubtreeCount(const RBTree *tree, const Node *node);
+
+/**
+ * @param tree: the tree of node.
+ * @param node: a node.
+ * @return: the cache of the item of node, NULL if the tree keeps none.
+ */
+const void *RBTreeItemCache(const RBTree *tree, const Node *node);
+
+
+#endif //RBTREE_RBTREEINTERNAL_H
@@ -0,0 +1,104 @@
+#ifndef RBTREE_RBTREENODES_H
+#define RBTREE_RBTREENODES_H
+
+#include "RBTree.h"
+
+/*
+ * the node level parts of RBTree.c that the functions generated by RBTreeTemplate.h are built from: the descents of
+ * the searches, and adding, deleting and iterating over nodes. they are declared here, apart from RBTreeInternal.h,
+ * so the template (and the headers of its trees) do not expose the other internals of the library.
+ */
+
+// the sides of a parent that a child is linked at.
+#define RBTREE_LEFT (-1)
+#define RBTREE_RIGHT (1)
+
+/**
+ * the descent of every search and insert, of RBTree.c and of the trees of RBTreeTemplate.h. walks down from root
+ * and stops at the node equal to the key searched for.
+ * @param root: the root of the sub-tree to search, may be NULL.
+ * @param cur: the name of the Node * variable of the descent, for COMPARISON.
+ * @param COMPARISON: an expression that compares the key with the item of cur like a CompareFunc.
+ * @param found: a Node * variable, receives the node equal to the key, NULL if there is none.
+ * @param parent: a Node * variable, receives the node to link a new node for the key under, NULL for the root.
+ * @param side: an int variable, receives the side of parent to link the new node at.
+ */
+#define RBTREE_DESCEND(root, cur, COMPARISON, found, parent, side) \
+	do \
+	{ \
+		Node *cur = (root); \
+		(found) = NULL; \
+		(parent) = NULL; \
+		(side) = RBTREE_LEFT; \
+		while (cur != NULL) \
+		{ \
+			int rbtreeCompRes = (COMPARISON); \
+			if (rbtreeCompRes == 0) \
+			{ \
+				(found) = cur; \
+				break; \
+			} \
+			(parent) = cur; \
+			(side) = rbtreeCompRes < 0 ? RBTREE_LEFT : RBTREE_RIGHT; \
+			cur = rbtreeCompRes < 0 ? cur->left : cur->right; \
+		} \
+		(void) (parent), (void) (side); /* searches use found only. */ \
+	} while (0)
+
+/**
+ * the descent of the lower bound searches, of RBTree.c and of the trees of RBTreeTemplate.h. finds the first node
+ * that is above a key.
+ * @param root: the root of the sub-tree to search, may be NULL.
+ * @param cur: the name of the Node * variable of the descent, for IS_ABOVE.
+ * @param IS_ABOVE: an expression that is true if cur is above the key, and then true for all the nodes after it.
+ * @param found: a Node * variable, receives the first node above the key, NULL if there is none.
+ */
+#define RBTREE_FIRST_ABOVE(root, cur, IS_ABOVE, found) \
+	do \
+	{ \
+		Node *cur = (root); \
+		(found) = NULL; \
+		while (cur != NULL) \
+		{ \
+			if (IS_ABOVE) \
+			{ \
+				(found) = cur; \
+				cur = cur->left; \
+			} \
+			else \
+			{ \
+				cur = cur->right; \
+			} \
+		} \
+	} while (0)
+
+/**
+ * adds a node with an item at the place found by RBTREE_DESCEND, fills what the tree keeps for it and rebalances the
+ * tree.
+ * @param tree: the tree to add the item to.
+ * @param data: the item, which must not be in the tree.
+ * @param parent: the parent found by RBTREE_DESCEND.
+ * @param side: the side found by RBTREE_DESCEND.
+ * @return: the new node, NULL if its allocation failed (the tree is not changed).
+ */
+Node *RBTreeAddNode(RBTree *tree, void *data, Node *parent, int side);
+
+/**
+ * removes a node from the tree and rebalances it, frees the item of the node with the FreeFunc of the tree and gives
+ * back the memory of the node.
+ * @param tree: the tree of node.
+ * @param node: the node to delete.
+ */
+void RBTreeDeleteNode(RBTree *tree, Node *node);
+
+/**
+ * positions an iterator on a node of a tree.
+ * @param tree: the tree of node.
+ * @param iter: the iterator to set, may be NULL.
+ * @param node: the node, NULL for the end.
+ * @return: the item of node, NULL for the end.
+ */
+void *RBTreePlaceIterator(const RBTree *tree, RBTreeIterator *iter, Node *node);
+
+
+#endif //RBTREE_RBTREENODES_H
@@ -0,0 +1,297 @@
+/**
+ * @file RBTreeParallel.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Parallel walks and set operations of RBTree.
+ *
+ * @section DESCRIPTION
+ * Holds the functions of RBTree that run on a ForkJoinPool, so RBTree.c builds without the pool and pthreads.
+ */
+// ------------------------------ includes ------------------------------
+#include "RBTreeParallel.h"
+#include "RBTreeInternal.h"
+// -------------------------- const definitions -------------------------
+#define FAILURE (0)
+#define SUCCESS (1)
+
+#define NOT_KEPT (0)
+
+#define PARALLEL_HEIGHT (8)
+
+#define PARTS_PER_WORKER (4)
+#define ONE_PART (1)
+// ------------------------------ structs -------------------------------
+/**
+ * A part of a parallel walk: a node followed by a sub-tree, spread over a range of parts.
+ */
+typedef struct WalkJob
+{
+    const RBTree *tree;
+    ForkJoinPool *pool;
+    forEachFunc func;
+    forEachCacheFunc cacheFunc; // used instead of func if it is not NULL.
+    void *shared; // the arguments of all the parts, if they have no partials.
+    void **partials; // the arguments of each part, may be NULL.
+    Node *pivot; // visited before node, may be NULL.
+    Node *node;
+    int firstPart, endPart;
+    int result;
+} WalkJob;
+// ------------------------------ functions -----------------------------
+
+static void walkJob(void *args);
+
+/**
+ * @brief Activates the function of a walk on the item of a node, with its cache if the walk reads caches.
+ * @param job The walk.
+ * @param node The node to visit.
+ * @param args The arguments of the function.
+ * @return The result of the function.
+ */
+static int visitNode(const WalkJob *job, const Node *node, void *args)
+{
+    if (job->cacheFunc != NULL)
+    {
+        return job->cacheFunc(node->data, RBTreeItemCache(job->tree, node), args);
+    }
+    return job->func(node->data, args);
+}
+
+/**
+ * @brief Visits the items of a sub-tree in ascending order, stopping at the first failed visit.
+ * @param job The walk.
+ * @param node The root of the sub-tree, may be NULL.
+ * @param args The arguments of the function of the walk.
+ * @return 0 on failure, 1 on success.
+ */
+static int visitSubtree(const WalkJob *job, Node *node, void *args)
+{
+    if (node == NULL)
+    {
+        return SUCCESS;
+    }
+    Node *cur = RBTreeLeftmost(node);
+    while (cur != NULL)
+    {
+        if (visitNode(job, cur, args) == FAILURE)
+        {
+            return FAILURE;
+        }
+        if (cur->right != NULL)
+        {
+            cur = RBTreeLeftmost(cur->right);
+            continue;
+        }
+        while (cur != node && getParent(cur)->right == cur)
+        {
+            cur = getParent(cur);
+        }
+        cur = cur == node ? NULL : getParent(cur);
+    }
+    return SUCCESS;
+}
+
+/**
+ * @brief Visits the pivot and sub-tree of a part of a parallel walk. The parts are split between the left sub-tree
+ * and the root with its right sub-tree, by their amounts of items when they are kept, and the two sides are forked.
+ * Each part visits a contiguous range of the items, so the parts are ordered like the items.
+ * @param job The part to walk, receives the result.
+ */
+static void walkNodes(WalkJob *job)
+{
+    void *args = job->partials != NULL ? job->partials[job->firstPart] : job->shared;
+    job->result = SUCCESS;
+    if (job->pivot != NULL && visitNode(job, job->pivot, args) == FAILURE)
+    {
+        job->result = FAILURE;
+        return;
+    }
+    Node *node = job->node;
+    int parts = job->endPart - job->firstPart;
+    if (parts <= ONE_PART || node == NULL)
+    {
+        job->result = visitSubtree(job, node, args);
+        return;
+    }
+    int mid = job->firstPart + parts / 2;
+    if (job->tree->countOffset != NOT_KEPT)
+    {
+        long unsigned leftCount = RBTreeSubtreeCount(job->tree, node->left);
+        mid = job->firstPart + (int) (parts * leftCount / RBTreeSubtreeCount(job->tree, node));
+        mid = mid > job->firstPart || node->left == NULL ? mid : job->firstPart + ONE_PART;
+    }
+    WalkJob left = *job, right = *job;
+    left.pivot = NULL, left.node = node->left, left.endPart = mid;
+    right.pivot = node, right.node = node->right, right.firstPart = mid;
+    forkJoin(job->pool, walkJob, &left, walkJob, &right);
+    job->result = left.result && right.result;
+}
+
+/**
+ * @brief The ForkJoinTask form of walkNodes.
+ * @param args The WalkJob.
+ */
+static void walkJob(void *args)
+{
+    walkNodes((WalkJob *) args);
+}
+
+/**
+ * Activate a function on each item of the tree, in parallel on a pool. the tree is split at its top levels into
+ * parts that the workers walk at once, so there is no order between the activations and func must be safe to call
+ * from several threads at once with the same args. if an activation returns 0, the rest of its part is skipped.
+ * @param tree: the tree with all the items. it must not change during the walk.
+ * @param pool: the pool to walk on, NULL to walk on the calling thread only.
+ * @param func: the function to activate on all items.
+ * @param args: more optional arguments to the function (may be null if the given function support it).
+ * @return: 0 on failure, other on success.
+ */
+int forEachRBTreeParallel(const RBTree *tree, ForkJoinPool *pool, forEachFunc func, void *args)
+{
+    if (tree == NULL || func == NULL)
+    {
+        return FAILURE;
+    }
+    int parts = pool != NULL ? forkJoinWorkers(pool) * PARTS_PER_WORKER : ONE_PART;
+    WalkJob job = {.tree = tree, .pool = pool, .func = func, .cacheFunc = NULL, .shared = args, .partials = NULL,
+                   .pivot = NULL, .node = tree->root, .firstPart = 0, .endPart = parts};
+    walkNodes(&job);
+    return job.result;
+}
+
+/**
+ * @brief Walks the items of a tree in contiguous ranges in parallel, then reduces the partials of the ranges in order.
+ * @param job The walk, with the tree, pool, function and partials set.
+ * @param parts The amount of partials.
+ * @param reduceFunc The function to merge a partial into the result of the ranges before it.
+ * @return 0 on failure, 1 on success.
+ */
+static int reduceParts(WalkJob *job, int parts, ReduceFunc reduceFunc)
+{
+    walkNodes(job);
+    for (int i = ONE_PART; i < parts && job->result; i++)
+    {
+        job->result = reduceFunc(job->partials[0], job->partials[i]);
+    }
+    return job->result;
+}
+
+/**
+ * Activate a function on each item of the tree in parallel, then reduce the results in order. the items are split
+ * into contiguous ranges, one per partial: the items of each range are visited in ascending order with its own
+ * partial as args, and the ranges run in parallel on a pool. then the partials are merged into the first one from
+ * left to right, so an order dependent reduction gives the same result as one forEachRBTree.
+ * @param tree: the tree with all the items. it must not change during the walk.
+ * @param pool: the pool to walk on, NULL to walk on the calling thread only.
+ * @param func: the function to activate on all items.
+ * @param partials: the arguments of the ranges, each must start as the identity of the reduction (a range may have
+ * no items). partials[0] receives the result.
+ * @param parts: the amount of partials, at least 1. a few per worker of the pool balance the work best.
+ * @param reduceFunc: the function to merge a partial into the result of the ranges before it.
+ * @return: 0 on failure, other on success.
+ */
+int reduceRBTreeParallel(const RBTree *tree, ForkJoinPool *pool, forEachFunc func, void **partials, int parts,
+                         ReduceFunc reduceFunc)
+{
+    if (tree == NULL || func == NULL || partials == NULL || parts < ONE_PART || reduceFunc == NULL)
+    {
+        return FAILURE;
+    }
+    WalkJob job = {.tree = tree, .pool = pool, .func = func, .cacheFunc = NULL, .shared = NULL,
+                   .partials = partials, .pivot = NULL, .node = tree->root, .firstPart = 0, .endPart = parts};
+    return reduceParts(&job, parts, reduceFunc);
+}
+
+/**
+ * like reduceRBTreeParallel, but the function also gets the cache the tree keeps for each item, so it does not have
+ * to recompute it.
+ * @param tree: the tree with all the items. it must not change during the walk.
+ * @param pool: the pool to walk on, NULL to walk on the calling thread only.
+ * @param func: the function to activate on all items and their caches.
+ * @param partials: the arguments of the ranges, each must start as the identity of the reduction (a range may have
+ * no items). partials[0] receives the result.
+ * @param parts: the amount of partials, at least 1. a few per worker of the pool balance the work best.
+ * @param reduceFunc: the function to merge a partial into the result of the ranges before it.
+ * @return: 0 on failure, other on success.
+ */
+int reduceRBTreeCachesParallel(const RBTree *tree, ForkJoinPool *pool, forEachCacheFunc func, void **partials,
+                               int parts, ReduceFunc reduceFunc)
+{
+    if (tree == NULL || func == NULL || partials == NULL || parts < ONE_PART || reduceFunc == NULL)
+    {
+        return FAILURE;
+    }
+    WalkJob job = {.tree = tree, .pool = pool, .func = NULL, .cacheFunc = func, .shared = NULL,
+                   .partials = partials, .pivot = NULL, .node = tree->root, .firstPart = 0, .endPart = parts};
+    return reduceParts(&job, parts, reduceFunc);
+}
+
+/**
+ * @brief The ForkJoinTask form of RBTreeCombineNodes.
+ * @param args The CombineJob.
+ */
+static void combineJob(void *args)
+{
+    RBTreeCombineNodes((CombineJob *) args);
+}
+
+/**
+ * @brief Combines the halves of a step of a set operation in parallel on the pool in the context of the jobs, if
+ * they are big enough to be worth it.
+ * @param left The job of the smaller half.
+ * @param right The job of the greater half.
+ */
+static void combineHalves(CombineJob *left, CombineJob *right)
+{
+    if (left->aHeight >= PARALLEL_HEIGHT && right->aHeight >= PARALLEL_HEIGHT &&
+        (left->bHeight >= PARALLEL_HEIGHT || right->bHeight >= PARALLEL_HEIGHT))
+    {
+        forkJoin((ForkJoinPool *) left->context, combineJob, left, combineJob, right);
+    }
+    else
+    {
+        RBTreeCombineNodes(left);
+        RBTreeCombineNodes(right);
+    }
+}
+
+/**
+ * like unionRBTree, but the halves of big trees are combined in parallel on a pool. the compare function of the
+ * tree must be safe to call from several threads at once.
+ * @param tree: the tree to hold the union.
+ * @param other: a tree made by newRBTreeLike(tree) or sharing its nodes. freed and set to NULL on success.
+ * @param pool: the pool to work on, NULL to work on the calling thread only.
+ * @return: 1 on success, 0 on failure (the trees can not share nodes, neither tree is changed).
+ */
+int unionRBTreeParallel(RBTree *tree, RBTree **other, ForkJoinPool *pool)
+{
+    return combineRBTrees(tree, other, UNITE, pool != NULL ? combineHalves : NULL, pool);
+}
+
+/**
+ * like intersectRBTree, but the halves of big trees are combined in parallel on a pool. the compare function of the
+ * tree must be safe to call from several threads at once.
+ * @param tree: the tree to hold the intersection.
+ * @param other: a tree made by newRBTreeLike(tree) or sharing its nodes. freed and set to NULL on success.
+ * @param pool: the pool to work on, NULL to work on the calling thread only.
+ * @return: 1 on success, 0 on failure (the trees can not share nodes, neither tree is changed).
+ */
+int intersectRBTreeParallel(RBTree *tree, RBTree **other, ForkJoinPool *pool)
+{
+    return combineRBTrees(tree, other, INTERSECT, pool != NULL ? combineHalves : NULL, pool);
+}
+
+/**
+ * like subtractRBTree, but the halves of big trees are combined in parallel on a pool. the compare function of the
+ * tree must be safe to call from several threads at once.
+ * @param tree: the tree to hold the difference.
+ * @param other: a tree made by newRBTreeLike(tree) or sharing its nodes. freed and set to NULL on success.
+ * @param pool: the pool to work on, NULL to work on the calling thread only.
+ * @return: 1 on success, 0 on failure (the trees can not share nodes, neither tree is changed).
+ */
+int subtractRBTreeParallel(RBTree *tree, RBTree **other, ForkJoinPool *pool)
+{
+    return combineRBTrees(tree, other, SUBTRACT, pool != NULL ? combineHalves : NULL, pool);
+}
@@ -0,0 +1,99 @@
+#ifndef RBTREE_RBTREEPARALLEL_H
+#define RBTREE_RBTREEPARALLEL_H
+
+#include "RBTree.h"
+#include "ForkJoinPool.h"
+
+/**
+ * a function to merge the partial result of a range of the tree into the result of the ranges before it.
+ * @result: the result of the ranges before part.
+ * @part: the partial result of the next range.
+ * @return: 0 on failure, other on success.
+ */
+typedef int (*ReduceFunc)(void *result, void *part);
+
+/**
+ * a function to apply on an item of the tree together with the cache the tree keeps for it.
+ * @object: a pointer to an item of the tree.
+ * @cache: the cache of the item, NULL if the tree keeps none.
+ * @args: pointer to other arguments for the function.
+ * @return: 0 on failure, other on success.
+ */
+typedef int (*forEachCacheFunc)(const void *object, const void *cache, void *args);
+
+/**
+ * Activate a function on each item of the tree, in parallel on a pool. the tree is split at its top levels into
+ * parts that the workers walk at once, so there is no order between the activations and func must be safe to call
+ * from several threads at once with the same args. if an activation returns 0, the rest of its part is skipped.
+ * @param tree: the tree with all the items. it must not change during the walk.
+ * @param pool: the pool to walk on, NULL to walk on the calling thread only.
+ * @param func: the function to activate on all items.
+ * @param args: more optional arguments to the function (may be null if the given function support it).
+ * @return: 0 on failure, other on success.
+ */
+int forEachRBTreeParallel(const RBTree *tree, ForkJoinPool *pool, forEachFunc func, void *args);
+
+/**
+ * Activate a function on each item of the tree in parallel, then reduce the results in order. the items are split
+ * into contiguous ranges, one per partial: the items of each range are visited in ascending order with its own
+ * partial as args, and the ranges run in parallel on a pool. then the partials are merged into the first one from
+ * left to right, so an order dependent reduction gives the same result as one forEachRBTree.
+ * @param tree: the tree with all the items. it must not change during the walk.
+ * @param pool: the pool to walk on, NULL to walk on the calling thread only.
+ * @param func: the function to activate on all items.
+ * @param partials: the arguments of the ranges, each must start as the identity of the reduction (a range may have
+ * no items). partials[0] receives the result.
+ * @param parts: the amount of partials, at least 1. a few per worker of the pool balance the work best.
+ * @param reduceFunc: the function to merge a partial into the result of the ranges before it.
+ * @return: 0 on failure, other on success.
+ */
+int reduceRBTreeParallel(const RBTree *tree, ForkJoinPool *pool, forEachFunc func, void **partials, int parts,
+                         ReduceFunc reduceFunc);
+
+/**
+ * like reduceRBTreeParallel, but the function also gets the cache the tree keeps for each item, so it does not have
+ * to recompute it.
+ * @param tree: the tree with all the items. it must not change during the walk.
+ * @param pool: the pool to walk on, NULL to walk on the calling thread only.
+ * @param func: the function to activate on all items and their caches.
+ * @param partials: the arguments of the ranges, each must start as the identity of the reduction (a range may have
+ * no items). partials[0] receives the result.
+ * @param parts: the amount of partials, at least 1. a few per worker of the pool balance the work best.
+ * @param reduceFunc: the function to merge a partial into the result of the ranges before it.
+ * @return: 0 on failure, other on success.
+ */
+int reduceRBTreeCachesParallel(const RBTree *tree, ForkJoinPool *pool, forEachCacheFunc func, void **partials,
+                               int parts, ReduceFunc reduceFunc);
+
+/**
+ * like unionRBTree, but the halves of big trees are combined in parallel on a pool. the compare function of the
+ * tree must be safe to call from several threads at once.
+ * @param tree: the tree to hold the union.
+ * @param other: a tree made by newRBTreeLike(tree) or sharing its nodes. freed and set to NULL on success.
+ * @param pool: the pool to work on, NULL to work on the calling thread only.
+ * @return: 1 on success, 0 on failure (the trees can not share nodes, neither tree is changed).
+ */
+int unionRBTreeParallel(RBTree *tree, RBTree **other, ForkJoinPool *pool);
+
+/**
+ * like intersectRBTree, but the halves of big trees are combined in parallel on a pool. the compare function of the
+ * tree must be safe to call from several threads at once.
+ * @param tree: the tree to hold the intersection.
+ * @param other: a tree made by newRBTreeLike(tree) or sharing its nodes. freed and set to NULL on success.
+ * @param pool: the pool to work on, NULL to work on the calling thread only.
+ * @return: 1 on success, 0 on failure (the trees can not share nodes, neither tree is changed).
+ */
+int intersectRBTreeParallel(RBTree *tree, RBTree **other, ForkJoinPool *pool);
+
+/**
+ * like subtractRBTree, but the halves of big trees are combined in parallel on a pool. the compare function of the
+ * tree must be safe to call from several threads at once.
+ * @param tree: the tree to hold the difference.
+ * @param other: a tree made by newRBTreeLike(tree) or sharing its nodes. freed and set to NULL on success.
+ * @param pool: the pool to work on, NULL to work on the calling thread only.
+ * @return: 1 on success, 0 on failure (the trees can not share nodes, neither tree is changed).
+ */
+int subtractRBTreeParallel(RBTree *tree, RBTree **other, ForkJoinPool *pool);
+
+
+#endif //RBTREE_RBTREEPARALLEL_H
@@ -0,0 +1,257 @@
+#ifndef RBTREE_RBTREETEMPLATE_H
+#define RBTREE_RBTREETEMPLATE_H
+
+#include "RBTree.h"
+#include "RBTreeNodes.h"
+#include <limits.h>
+#include <string.h>
+
+/*
+ * generates the search, insert and delete functions of RBTree for one type of items and one comparison, so the
+ * comparison of every step is compiled inline instead of called through the CompareFunc of the tree. the trees are
+ * plain RBTrees: every other function of RBTree.h works on them, through a CompareFunc that wraps the same comparison.
+ * the descents are RBTREE_DESCEND and RBTREE_FIRST_ABOVE of RBTreeNodes.h and the nodes are added and deleted by
+ * RBTreeAddNode and RBTreeDeleteNode, like in RBTree.c.
+ *
+ * RBTREE_DECLARE(prefix, ItemType); declares, in a header:
+ * RBTree *prefix##New(FreeFunc freeFunc, const RBTreeOptions *options): a tree of ItemType items, NULL on failure.
+ * int prefix##CompareItems(const void *a, const void *b): the CompareFunc of the trees.
+ * int prefix##Insert(RBTree *tree, ItemType *item): like insertToRBTree.
+ * int prefix##Delete(RBTree *tree, const ItemType *item): like deleteFromRBTree.
+ * int prefix##Contains(const RBTree *tree, const ItemType *item): like RBTreeContains.
+ * ItemType *prefix##Find(const RBTree *tree, const ItemType *key): the item of the tree equal to key, NULL if none.
+ * ItemType *prefix##LowerBound(const RBTree *tree, const ItemType *key, RBTreeIterator *iter): like RBTreeLowerBound.
+ * the functions fail (or find nothing) on trees that were not made by prefix##New or newRBTreeLike of one.
+ *
+ * RBTREE_DEFINE(prefix, ItemType, COMPARE) defines them, in one source file. COMPARE(a, b) is a function or macro
+ * that compares two const ItemType * like a CompareFunc. for example, a tree of doubles:
+ *     #define COMPARE_DOUBLES(a, b) RBTREE_COMPARE_NUMBERS(*(a), *(b))
+ *     RBTREE_DEFINE(doubleTree, double, COMPARE_DOUBLES)
+ */
+
+/**
+ * compares two numbers without branches or overflow.
+ * @return: -1 if a < b, 1 if b < a, 0 otherwise.
+ */
+#define RBTREE_COMPARE_NUMBERS(a, b) (((a) > (b)) - ((a) < (b)))
+
+#define RBTREE_DECLARE(prefix, ItemType) \
+	RBTree *prefix##New(FreeFunc freeFunc, const RBTreeOptions *options); \
+	int prefix##CompareItems(const void *a, const void *b); \
+	int prefix##Insert(RBTree *tree, ItemType *item); \
+	int prefix##Delete(RBTree *tree, const ItemType *item); \
+	int prefix##Contains(const RBTree *tree, const ItemType *item); \
+	ItemType *prefix##Find(const RBTree *tree, const ItemType *key); \
+	ItemType *prefix##LowerBound(const RBTree *tree, const ItemType *key, RBTreeIterator *iter)
+
+#define RBTREE_DEFINE(prefix, ItemType, COMPARE) \
+	int prefix##CompareItems(const void *a, const void *b) \
+	{ \
+		return COMPARE((const ItemType *) a, (const ItemType *) b); \
+	} \
+	\
+	RBTree *prefix##New(FreeFunc freeFunc, const RBTreeOptions *options) \
+	{ \
+		return newRBTreeWithOptions(prefix##CompareItems, freeFunc, options); \
+	} \
+	\
+	static Node *prefix##FindNode(const RBTree *tree, const ItemType *key) \
+	{ \
+		Node *found, *parent; \
+		int side; \
+		RBTREE_DESCEND(tree->root, cur, COMPARE(key, (const ItemType *) cur->data), found, parent, side); \
+		return found; \
+	} \
+	\
+	int prefix##Insert(RBTree *tree, ItemType *item) \
+	{ \
+		if (tree == NULL || item == NULL || tree->compFunc != prefix##CompareItems) \
+		{ \
+			return 0; \
+		} \
+		Node *found, *parent; \
+		int side; \
+		RBTREE_DESCEND(tree->root, cur, COMPARE((const ItemType *) item, (const ItemType *) cur->data), found, parent, \
+		               side); \
+		return found == NULL && RBTreeAddNode(tree, (void *) item, parent, side) != NULL; \
+	} \
+	\
+	int prefix##Delete(RBTree *tree, const ItemType *item) \
+	{ \
+		if (tree == NULL || item == NULL || tree->compFunc != prefix##CompareItems) \
+		{ \
+			return 0; \
+		} \
+		Node *toDelete = prefix##FindNode(tree, item); \
+		if (toDelete == NULL) \
+		{ \
+			return 0; \
+		} \
+		RBTreeDeleteNode(tree, toDelete); \
+		return 1; \
+	} \
+	\
+	ItemType *prefix##Find(const RBTree *tree, const ItemType *key) \
+	{ \
+		if (tree == NULL || key == NULL || tree->compFunc != prefix##CompareItems) \
+		{ \
+			return NULL; \
+		} \
+		Node *found = prefix##FindNode(tree, key); \
+		return found != NULL ? (ItemType *) found->data : NULL; \
+	} \
+	\
+	int prefix##Contains(const RBTree *tree, const ItemType *item) \
+	{ \
+		return prefix##Find(tree, item) != NULL; \
+	} \
+	\
+	ItemType *prefix##LowerBound(const RBTree *tree, const ItemType *key, RBTreeIterator *iter) \
+	{ \
+		if (tree == NULL || key == NULL || tree->compFunc != prefix##CompareItems) \
+		{ \
+			return (ItemType *) RBTreePlaceIterator(tree, iter, NULL); \
+		} \
+		Node *found; \
+		RBTREE_FIRST_ABOVE(tree->root, cur, COMPARE(key, (const ItemType *) cur->data) <= 0, found); \
+		return (ItemType *) RBTreePlaceIterator(tree, iter, found); \
+	}
+
+/*
+ * generates a tree whose keys are kept in the nodes in place of the item pointers, for key types that fit in a
+ * pointer (integers, doubles...). adding a key allocates nothing but its node, and searches read no memory but the
+ * nodes.
+ *
+ * RBTREE_DECLARE_KEYS(prefix, KeyType); declares, in a header:
+ * RBTree *prefix##New(const RBTreeOptions *options): a tree of KeyType keys, NULL on failure.
+ * int prefix##CompareItems(const void *a, const void *b): the CompareFunc of the trees.
+ * void *prefix##Item(KeyType key): the item pointer that holds key, to pass to the functions of RBTree.h.
+ * KeyType prefix##Key(const void *item): the key held by an item pointer, to read the items of RBTree.h functions.
+ * int prefix##Insert(RBTree *tree, KeyType key): like insertToRBTree, fails on the key held by a NULL item.
+ * int prefix##Delete(RBTree *tree, KeyType key): like deleteFromRBTree.
+ * int prefix##Contains(const RBTree *tree, KeyType key): like RBTreeContains.
+ * int prefix##LowerBound(const RBTree *tree, KeyType key, RBTreeIterator *iter, KeyType *found): like
+ * RBTreeLowerBound, writes the key found (if found is not NULL) and returns 1, or returns 0 if there is none.
+ * int prefix##IteratorKey(const RBTreeIterator *iter, KeyType *key): writes the key at the position of iter and
+ * returns 1, or returns 0 at the end position.
+ * the key whose bits are only the highest bit of a pointer (INT64_MIN, -0.0 on 64 bit machines) would be held by a
+ * NULL item, which the functions of RBTree.h that take items reject and those that return items can not tell from
+ * the end. prefix##Insert rejects it, so the trees never hold it.
+ *
+ * RBTREE_DEFINE_KEYS(prefix, KeyType, COMPARE) defines them, in one source file that includes the declarations.
+ * COMPARE(a, b) compares two KeyType values like a CompareFunc, e.g. RBTREE_COMPARE_NUMBERS.
+ */
+
+// flipped in the bits of a key, so the common key 0 is not held by a NULL item.
+#define RBTREE_KEY_FLIP ((uintptr_t) 1 << (sizeof(uintptr_t) * CHAR_BIT - 1))
+
+#define RBTREE_DECLARE_KEYS(prefix, KeyType) \
+	typedef char prefix##KeyFitsInPointer[sizeof(KeyType) <= sizeof(uintptr_t) ? 1 : -1]; \
+	\
+	static inline void *prefix##Item(KeyType key) \
+	{ \
+		uintptr_t bits = 0; \
+		memcpy(&bits, &key, sizeof(KeyType)); \
+		return (void *) (bits ^ RBTREE_KEY_FLIP); \
+	} \
+	\
+	static inline KeyType prefix##Key(const void *item) \
+	{ \
+		uintptr_t bits = (uintptr_t) item ^ RBTREE_KEY_FLIP; \
+		KeyType key; \
+		memcpy(&key, &bits, sizeof(KeyType)); \
+		return key; \
+	} \
+	\
+	RBTree *prefix##New(const RBTreeOptions *options); \
+	int prefix##CompareItems(const void *a, const void *b); \
+	int prefix##Insert(RBTree *tree, KeyType key); \
+	int prefix##Delete(RBTree *tree, KeyType key); \
+	int prefix##Contains(const RBTree *tree, KeyType key); \
+	int prefix##LowerBound(const RBTree *tree, KeyType key, RBTreeIterator *iter, KeyType *found); \
+	int prefix##IteratorKey(const RBTreeIterator *iter, KeyType *key)
+
+#define RBTREE_DEFINE_KEYS(prefix, KeyType, COMPARE) \
+	int prefix##CompareItems(const void *a, const void *b) \
+	{ \
+		return COMPARE(prefix##Key(a), prefix##Key(b)); \
+	} \
+	\
+	RBTree *prefix##New(const RBTreeOptions *options) \
+	{ \
+		return newRBTreeWithOptions(prefix##CompareItems, NULL, options); \
+	} \
+	\
+	static Node *prefix##FindNode(const RBTree *tree, KeyType key) \
+	{ \
+		Node *found, *parent; \
+		int side; \
+		RBTREE_DESCEND(tree->root, cur, COMPARE(key, prefix##Key(cur->data)), found, parent, side); \
+		return found; \
+	} \
+	\
+	int prefix##Insert(RBTree *tree, KeyType key) \
+	{ \
+		if (tree == NULL || tree->compFunc != prefix##CompareItems || prefix##Item(key) == NULL) \
+		{ \
+			return 0; \
+		} \
+		Node *found, *parent; \
+		int side; \
+		RBTREE_DESCEND(tree->root, cur, COMPARE(key, prefix##Key(cur->data)), found, parent, side); \
+		return found == NULL && RBTreeAddNode(tree, prefix##Item(key), parent, side) != NULL; \
+	} \
+	\
+	int prefix##Delete(RBTree *tree, KeyType key) \
+	{ \
+		if (tree == NULL || tree->compFunc != prefix##CompareItems) \
+		{ \
+			return 0; \
+		} \
+		Node *toDelete = prefix##FindNode(tree, key); \
+		if (toDelete == NULL) \
+		{ \
+			return 0; \
+		} \
+		RBTreeDeleteNode(tree, toDelete); \
+		return 1; \
+	} \
+	\
+	int prefix##Contains(const RBTree *tree, KeyType key) \
+	{ \
+		if (tree == NULL || tree->compFunc != prefix##CompareItems) \
+		{ \
+			return 0; \
+		} \
+		return prefix##FindNode(tree, key) != NULL; \
+	} \
+	\
+	int prefix##IteratorKey(const RBTreeIterator *iter, KeyType *key) \
+	{ \
+		if (iter == NULL || iter->node == NULL) \
+		{ \
+			return 0; \
+		} \
+		if (key != NULL) \
+		{ \
+			*key = prefix##Key(iter->node->data); \
+		} \
+		return 1; \
+	} \
+	\
+	int prefix##LowerBound(const RBTree *tree, KeyType key, RBTreeIterator *iter, KeyType *found) \
+	{ \
+		Node *bound = NULL; \
+		if (tree != NULL && tree->compFunc == prefix##CompareItems) \
+		{ \
+			RBTREE_FIRST_ABOVE(tree->root, cur, COMPARE(key, prefix##Key(cur->data)) <= 0, bound); \
+		} \
+		RBTreeIterator place = {.tree = tree, .node = bound}; \
+		if (iter != NULL) \
+		{ \
+			*iter = place; \
+		} \
+		return prefix##IteratorKey(&place, found); \
+	}
+
+#endif //RBTREE_RBTREETEMPLATE_H
@@ -0,0 +1,250 @@
+/**
+ * @file StringArena.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 22 may 2020
+ *
+ * @brief An interning pool of strings stored in big blocks.
+ *
+ * @section DESCRIPTION
+ * Holds the implementation of a StringArena. The strings are packed one after the other into blocks, and an open
+ * addressing hash table of the stored strings finds the copy of a string that was interned before.
+ */
+// ------------------------------ includes ------------------------------
+#include "StringArena.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+// -------------------------- const definitions -------------------------
+#define FAILURE (0)
+#define SUCCESS (1)
+
+#define NO_ITEMS (0)
+
+#define BLOCK_SIZE ((size_t) 64 * 1024)
+#define INITIAL_SLOTS ((size_t) 1024)
+#define GROWTH_FACTOR (2)
+#define MAX_LOAD_NUMERATOR (1)
+#define MAX_LOAD_DENOMINATOR (2)
+
+#define FNV_OFFSET ((uint64_t) 14695981039346656037u)
+#define FNV_PRIME ((uint64_t) 1099511628211u)
+// ------------------------------ structs -------------------------------
+/**
+ * A chunk of strings. The strings are stored right after the header.
+ */
+typedef struct Block
+{
+    struct Block *next;
+    size_t used, size;
+} Block;
+
+/**
+ * A place of the hash table. Empty places have no string.
+ */
+typedef struct Slot
+{
+    uint64_t hash;
+    const char *string;
+} Slot;
+
+struct StringArena
+{
+    Block *blocks; // the block strings are added to first, the others follow it.
+    Slot *slots;
+    size_t slotsAmount; // a power of 2.
+    long unsigned size;
+};
+// ------------------------------ functions -----------------------------
+
+/**
+ * @brief The FNV-1a hash of a string.
+ * @param string A null terminated string.
+ * @param length Receives the length of the string.
+ * @return The hash.
+ */
+static uint64_t hashString(const char *string, size_t *length)
+{
+    uint64_t hash = FNV_OFFSET;
+    const char *cur = string;
+    for (; *cur != '\0'; cur++)
+    {
+        hash = (hash ^ (unsigned char) *cur) * FNV_PRIME;
+    }
+    *length = (size_t) (cur - string);
+    return hash;
+}
+
+/**
+ * @brief Finds the slot of a string, or the empty slot where it belongs.
+ * @param slots The hash table.
+ * @param slotsAmount The amount of slots, a power of 2.
+ * @param hash The hash of the string.
+ * @param string The string to find, NULL to find only an empty slot.
+ * @return The slot.
+ */
+static Slot *findSlot(Slot *slots, size_t slotsAmount, uint64_t hash, const char *string)
+{
+    size_t mask = slotsAmount - 1;
+    for (size_t i = (size_t) hash & mask;; i = (i + 1) & mask)
+    {
+        Slot *slot = &slots[i];
+        if (slot->string == NULL ||
+            (string != NULL && slot->hash == hash && strcmp(slot->string, string) == 0))
+        {
+            return slot;
+        }
+    }
+}
+
+/**
+ * @brief Doubles the hash table, placing every string again.
+ * @param arena The arena to grow the table of.
+ * @return 1 on success, 0 on failure (the table is not changed).
+ */
+static int growSlots(StringArena *arena)
+{
+    size_t slotsAmount = arena->slotsAmount * GROWTH_FACTOR;
+    Slot *slots = (Slot *) calloc(slotsAmount, sizeof(Slot));
+    if (slots == NULL)
+    {
+        return FAILURE;
+    }
+    for (size_t i = 0; i < arena->slotsAmount; i++)
+    {
+        if (arena->slots[i].string != NULL)
+        {
+            *findSlot(slots, slotsAmount, arena->slots[i].hash, NULL) = arena->slots[i];
+        }
+    }
+    free(arena->slots);
+    arena->slots = slots;
+    arena->slotsAmount = slotsAmount;
+    return SUCCESS;
+}
+
+/**
+ * @brief Makes room for a string in the blocks, adding a block if the first one is full. A string longer than a
+ * block gets a block of its own, behind the first one.
+ * @param arena The arena to store the string in.
+ * @param size The bytes of the string, its null terminator included.
+ * @return The room for the string, NULL on failure.
+ */
+static char *storeString(StringArena *arena, size_t size)
+{
+    Block *block = arena->blocks;
+    if (block == NULL || block->size - block->used < size)
+    {
+        size_t blockSize = size > BLOCK_SIZE ? size : BLOCK_SIZE;
+        Block *added = (Block *) malloc(sizeof(Block) + blockSize);
+        if (added == NULL)
+        {
+            return NULL;
+        }
+        *added = (Block) {.next = NULL, .used = 0, .size = blockSize};
+        if (block != NULL && blockSize > BLOCK_SIZE)
+        {
+            added->next = block->next;
+            block->next = added;
+        }
+        else
+        {
+            added->next = block;
+            arena->blocks = added;
+        }
+        block = added;
+    }
+    char *room = (char *) (block + 1) + block->used;
+    block->used += size;
+    return room;
+}
+
+/**
+ * constructs a new empty StringArena.
+ * @return: the new arena, NULL on failure.
+ */
+StringArena *newStringArena(void)
+{
+    StringArena *arena = (StringArena *) malloc(sizeof(StringArena));
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+    *arena = (StringArena) {.blocks = NULL, .slots = NULL, .slotsAmount = INITIAL_SLOTS, .size = NO_ITEMS};
+    arena->slots = (Slot *) calloc(INITIAL_SLOTS, sizeof(Slot));
+    if (arena->slots == NULL)
+    {
+        free(arena);
+        return NULL;
+    }
+    return arena;
+}
+
+/**
+ * get the copy of a string in the arena, copying it in if it is not there yet.
+ * @param arena: the arena to intern the string in.
+ * @param string: a null terminated string.
+ * @return: the copy of string in the arena, NULL on failure.
+ */
+const char *internString(StringArena *arena, const char *string)
+{
+    if (arena == NULL || string == NULL)
+    {
+        return NULL;
+    }
+    size_t length;
+    uint64_t hash = hashString(string, &length);
+    Slot *slot = findSlot(arena->slots, arena->slotsAmount, hash, string);
+    if (slot->string != NULL)
+    {
+        return slot->string;
+    }
+    if ((arena->size + 1) * MAX_LOAD_DENOMINATOR > arena->slotsAmount * MAX_LOAD_NUMERATOR)
+    {
+        if (!growSlots(arena))
+        {
+            return NULL;
+        }
+        slot = findSlot(arena->slots, arena->slotsAmount, hash, NULL);
+    }
+    char *copy = storeString(arena, length + 1);
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    memcpy(copy, string, length + 1);
+    *slot = (Slot) {.hash = hash, .string = copy};
+    (arena->size)++;
+    return copy;
+}
+
+/**
+ * @param arena: an arena.
+ * @return: the amount of different strings in the arena.
+ */
+long unsigned stringArenaSize(const StringArena *arena)
+{
+    return arena->size;
+}
+
+/**
+ * free all memory of the arena and its strings, in time proportional to the amount of blocks. (a FreeFunc)
+ * @param arena: the arena to free, may be NULL.
+ */
+void freeStringArena(void *arena)
+{
+    StringArena *strings = (StringArena *) arena;
+    if (strings == NULL)
+    {
+        return;
+    }
+    Block *block = strings->blocks;
+    while (block != NULL)
+    {
+        Block *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(strings->slots);
+    free(strings);
+}
@@ -0,0 +1,37 @@
+#ifndef RBTREE_STRINGARENA_H
+#define RBTREE_STRINGARENA_H
+
+/**
+ * an interning pool of strings. strings are copied into big blocks, and equal strings are stored once, so a string
+ * of the arena can be compared to another by its address. the strings stay until the whole arena is freed.
+ */
+typedef struct StringArena StringArena;
+
+/**
+ * constructs a new empty StringArena.
+ * @return: the new arena, NULL on failure.
+ */
+StringArena *newStringArena(void);
+
+/**
+ * get the copy of a string in the arena, copying it in if it is not there yet.
+ * @param arena: the arena to intern the string in.
+ * @param string: a null terminated string.
+ * @return: the copy of string in the arena, NULL on failure.
+ */
+const char *internString(StringArena *arena, const char *string);
+
+/**
+ * @param arena: an arena.
+ * @return: the amount of different strings in the arena.
+ */
+long unsigned stringArenaSize(const StringArena *arena);
+
+/**
+ * free all memory of the arena and its strings, in time proportional to the amount of blocks. (a FreeFunc)
+ * @param arena: the arena to free, may be NULL.
+ */
+void freeStringArena(void *arena);
+
+
+#endif //RBTREE_STRINGARENA_H
@@ -11,6 +11,8 @@
  */
 // ------------------------------ includes ------------------------------
 #include "Structs.h"
+#include "StringArena.h"
+#include "VectorKernels.h"
 #include <stdlib.h>
 #include <string.h>
 // -------------------------- const definitions -------------------------
@@ -18,15 +20,42 @@
 
 #define SUCCESS (1)
 
-const int VECTOR_AMOUNT = 1;
+static const int VECTOR_AMOUNT = 1;
 
-const int START_VAL = 0;
+static const int START_VAL = 0;
 
-const int STARTING_IDX = 0;
+static const int STARTING_IDX = 0;
 
-const int SMALLER = -1;
+static const int SMALLER = -1;
 
-const int GREATER = 1;
+static const int GREATER = 1;
+
+static const int PARTS_PER_WORKER = 4;
+
+static const int ONE_PART = 1;
+
+static const int NO_AUGMENTATION = -1;
+
+static const int MAX_NORM_AUGMENTATIONS = 1;
+
+static const size_t GROWTH_FACTOR = 2;
+
+static const size_t NULL_TERMINATOR = 1;
+
+static const int PREFIX_BYTES = 8;
+
+static const int BITS_IN_BYTE = 8;
+
+static const uint64_t SIGN_BIT = (uint64_t) 1 << 63;
+// ------------------------------ structs -------------------------------
+/**
+ * The vector with the largest norm in a part of a tree, and its norm.
+ */
+typedef struct MaxNorm
+{
+    double norm;
+    const Vector *vec;
+} MaxNorm;
 // ------------------------------ functions -----------------------------
 /**
  * CompFunc for strings (assumes strings end with "\0")
@@ -40,6 +69,28 @@ int stringCompare(const void *a, const void *b)
     return strcmp((char *) a, (char *) b);
 }
 
+/**
+ * PrefixFunc for strings: the first 8 characters as a big-endian number, padded with zeros, so it sorts like
+ * stringCompare.
+ * @param s - char* pointer
+ * @return the prefix of the string
+ */
+uint64_t stringPrefix(const void *s)
+{
+    const unsigned char *string = (const unsigned char *) s;
+    uint64_t prefix = START_VAL;
+    int i = START_VAL;
+    for (; i < PREFIX_BYTES && string[i] != '\0'; ++i)
+    {
+        prefix = prefix << BITS_IN_BYTE | string[i];
+    }
+    for (; i < PREFIX_BYTES; ++i)
+    {
+        prefix <<= BITS_IN_BYTE;
+    }
+    return prefix;
+}
+
 /**
  * ForEach function that concatenates the given word and \n to pConcatenated. pConcatenated is
  * already allocated with enough space.
@@ -65,6 +116,150 @@ void freeString(void *s)
     free((char *) s);
 }
 
+/**
+ * Initializes an empty StringBuilder.
+ * @param builder the builder to initialize
+ * @param capacity the amount of characters to make room for (more are appended by growing the buffer)
+ * @return 1 on success, 0 on failure
+ */
+int initStringBuilder(StringBuilder *builder, size_t capacity)
+{
+    builder->string = (char *) malloc(capacity + NULL_TERMINATOR);
+    if (builder->string == NULL)
+    {
+        return FAILURE;
+    }
+    builder->string[START_VAL] = '\0';
+    builder->length = START_VAL;
+    builder->capacity = capacity;
+    return SUCCESS;
+}
+
+/**
+ * ForEach function that appends the given word to a StringBuilder, growing its buffer if needed.
+ * @param word - char* to append
+ * @param pBuilder - StringBuilder*
+ * @return 0 on failure, other on success
+ */
+int appendString(const void *word, void *pBuilder)
+{
+    StringBuilder *builder = (StringBuilder *) pBuilder;
+    if (word == NULL || builder == NULL || builder->string == NULL)
+    {
+        return FAILURE;
+    }
+    size_t wordLen = strlen((const char *) word);
+    if (builder->length + wordLen > builder->capacity)
+    {
+        size_t capacity = builder->capacity * GROWTH_FACTOR;
+        capacity = capacity < builder->length + wordLen ? builder->length + wordLen : capacity;
+        char *alloc = (char *) realloc(builder->string, capacity + NULL_TERMINATOR);
+        if (alloc == NULL)
+        {
+            return FAILURE;
+        }
+        builder->string = alloc;
+        builder->capacity = capacity;
+    }
+    memcpy(builder->string + builder->length, word, wordLen + NULL_TERMINATOR);
+    builder->length += wordLen;
+    return SUCCESS;
+}
+
+/**
+ * ForEach function that adds the length of the given word to a total, to size a StringBuilder exactly.
+ * @param word - char*
+ * @param pLength - size_t* of the total
+ * @return 0 on failure, other on success
+ */
+int addStringLength(const void *word, void *pLength)
+{
+    if (word == NULL || pLength == NULL)
+    {
+        return FAILURE;
+    }
+    *(size_t *) pLength += strlen((const char *) word);
+    return SUCCESS;
+}
+
+/**
+ * Frees the buffer of a StringBuilder.
+ * @param builder the builder to free
+ */
+void freeStringBuilder(StringBuilder *builder)
+{
+    free(builder->string);
+    builder->string = NULL;
+    builder->length = START_VAL;
+    builder->capacity = START_VAL;
+}
+
+/**
+ * Concatenates the strings of a tree by order, like forEachRBTree with concatenate, in time linear in the total
+ * length. The total length is found first, so the result is allocated once and exactly.
+ * @param tree a pointer to a tree of strings
+ * @return the concatenation, to free with freeString, NULL on failure.
+ */
+char *concatenateTree(const RBTree *tree)
+{
+    size_t length = START_VAL;
+    if (!forEachRBTree(tree, addStringLength, (void *) &length))
+    {
+        return NULL;
+    }
+    StringBuilder builder;
+    if (!initStringBuilder(&builder, length))
+    {
+        return NULL;
+    }
+    if (!forEachRBTree(tree, appendString, (void *) &builder))
+    {
+        freeStringBuilder(&builder);
+        return NULL;
+    }
+    return builder.string;
+}
+
+/**
+ * Constructs a tree of strings that stores its strings in a StringArena it owns, instead of allocating each one.
+ * Equal strings share one copy, and freeing the tree frees all of them at once. The strings of deleted items stay in
+ * the arena until the tree (and the trees made like it) are freed.
+ * @param options the features of the tree, NULL for the defaults of newRBTree
+ * @return the new tree, NULL on failure
+ */
+RBTree *newStringArenaRBTree(const RBTreeOptions *options)
+{
+    RBTree *tree = newRBTreeWithOptions(stringCompare, NULL, options);
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+    StringArena *arena = newStringArena();
+    if (arena == NULL || !ownRBTreeResource(tree, arena, freeStringArena))
+    {
+        freeStringArena(arena);
+        freeRBTree(&tree);
+        return NULL;
+    }
+    return tree;
+}
+
+/**
+ * Copies a string into the arena of a tree made by newStringArenaRBTree and adds the copy to the tree.
+ * @param tree a tree made by newStringArenaRBTree (or like one)
+ * @param string the string to add, stays owned by the caller
+ * @return 0 on failure, other on success (if the string is already in the tree - failure)
+ */
+int insertStringToRBTree(RBTree *tree, const char *string)
+{
+    const char *interned = internString((StringArena *) RBTreeResource(tree), string);
+    if (interned == NULL)
+    {
+        return FAILURE;
+    }
+    return insertToRBTree(tree, (void *) interned);
+}
+
 /**
  * CompFunc for Vectors, compares element by element, the vector that has the first larger
  * element is considered larger. If vectors are of different lengths and identify for the length
@@ -93,22 +288,39 @@ int vectorCompare1By1(const void *a, const void *b)
         len = vecB->len;
         shortVec = GREATER;
     }
-    double aCoord, bCoord;
-    for (int i = STARTING_IDX; i < len; ++i)
+    int i = firstDifference(vecA->vector, vecB->vector, len);
+    if (i == len)
     {
-        aCoord = vecA->vector[i], bCoord = vecB->vector[i];
-        if (aCoord < bCoord)
-        {
-            return SMALLER;
-        }
-        else if (aCoord > bCoord)
-        {
-            return GREATER;
-        }
+        return shortVec;
     }
-    return shortVec;
+    return vecA->vector[i] < vecB->vector[i] ? SMALLER : GREATER;
 }
 
+/**
+ * PrefixFunc for Vectors: the bits of the first coordinate, reordered to sort like the coordinate, 0 for an empty
+ * vector. Vectors whose first coordinate is NaN do not sort consistently by vectorCompare1By1, and must not be used.
+ * @param v - Vector* pointer
+ * @return the prefix of the vector
+ */
+uint64_t vectorPrefix(const void *v)
+{
+    const Vector *vec = (const Vector *) v;
+    if (vec->len == START_VAL)
+    {
+        return START_VAL;
+    }
+    // -0.0 equals 0.0, so both get the bits of 0.0.
+    double first = vec->vector[STARTING_IDX] == START_VAL ? START_VAL : vec->vector[STARTING_IDX];
+    uint64_t bits;
+    memcpy(&bits, &first, sizeof(bits));
+    // negative numbers sort in reverse by their bits, and below all positive ones.
+    return (bits & SIGN_BIT) ? ~bits : bits | SIGN_BIT;
+}
+
+RBTREE_DEFINE(vectorTree, Vector, vectorCompare1By1)
+
+RBTREE_DEFINE(stringTree, char, stringCompare)
+
 /**
  * FreeFunc for vectors
  */
@@ -125,12 +337,19 @@ void freeVector(void *pVector)
  */
 double getNorm(Vector *vec, int vecLen)
 {
-    double squaredNorm = START_VAL;
-    for (int i = STARTING_IDX; i < vecLen; ++i)
-    {
-        squaredNorm += (vec->vector[i] * vec->vector[i]);
-    }
-    return squaredNorm;
+    return sumOfSquares(vec->vector, vecLen);
+}
+
+/**
+ * CacheFunc for Vectors, keeps the norm of the vector (a double) so it is computed once, when the vector is added.
+ * use with a cacheSize of sizeof(double). findMaxNormVectorInTree reads the cached norms of such trees.
+ * @param pVector pointer to Vector
+ * @param pNorm pointer to the double to write the norm to
+ */
+void cacheNorm(const void *pVector, void *pNorm)
+{
+    const Vector *pVec = (const Vector *) pVector;
+    *(double *) pNorm = getNorm((Vector *) pVec, pVec->len);
 }
 
 /**
@@ -168,21 +387,209 @@ int copyIfNormIsLarger(const void *pVector, void *pMaxVector)
     return SUCCESS;
 }
 
+/**
+ * forEachCacheFunc that keeps pVector in pMaxNorm if its norm is greater than the one kept, or none is kept yet.
+ * @param pVector pointer to Vector
+ * @param cache the norm cached by cacheNorm, or NULL to compute it
+ * @param pMaxNorm pointer to MaxNorm
+ * @return 1 on success, 0 on failure (if pVector == NULL: failure).
+ */
+static int keepCachedNormIfLarger(const void *pVector, const void *cache, void *pMaxNorm)
+{
+    const Vector *pVec = (const Vector *) pVector;
+    MaxNorm *maxNorm = (MaxNorm *) pMaxNorm;
+    if (pVec == NULL)
+    {
+        return FAILURE;
+    }
+    double norm = cache != NULL ? *(const double *) cache : getNorm((Vector *) pVec, pVec->len);
+    if (maxNorm->vec == NULL || norm > maxNorm->norm)
+    {
+        *maxNorm = (MaxNorm) {.norm = norm, .vec = pVec};
+    }
+    return SUCCESS;
+}
+
+/**
+ * ForEach function that keeps pVector in pMaxNorm if its norm is greater than the one kept, or none is kept yet.
+ * @param pVector pointer to Vector
+ * @param pMaxNorm pointer to MaxNorm
+ * @return 1 on success, 0 on failure (if pVector == NULL: failure).
+ */
+static int keepIfNormIsLarger(const void *pVector, void *pMaxNorm)
+{
+    return keepCachedNormIfLarger(pVector, NULL, pMaxNorm);
+}
+
+/**
+ * ReduceFunc for MaxNorms, keeps the earlier vector on equal norms like one ordered walk would.
+ * @param result the MaxNorm of the earlier parts
+ * @param part the MaxNorm of the next part
+ * @return 1
+ */
+static int mergeMaxNorms(void *result, void *part)
+{
+    MaxNorm *maxNorm = (MaxNorm *) result;
+    const MaxNorm *partMax = (const MaxNorm *) part;
+    if (partMax->vec != NULL && (maxNorm->vec == NULL || partMax->norm > maxNorm->norm))
+    {
+        *maxNorm = *partMax;
+    }
+    return SUCCESS;
+}
+
+/**
+ * SummarizeFunc for Vectors, summarizes a vector as the vector with the largest norm of its sub-tree (a MaxNorm).
+ * @param summary pointer to the MaxNorm to write
+ * @param pVector pointer to Vector
+ * @param cache the norm cached by cacheNorm, or NULL to compute it
+ */
+static void summarizeMaxNorm(void *summary, const void *pVector, const void *cache)
+{
+    const Vector *pVec = (const Vector *) pVector;
+    double norm = cache != NULL ? *(const double *) cache : getNorm((Vector *) pVec, pVec->len);
+    *(MaxNorm *) summary = (MaxNorm) {.norm = norm, .vec = pVec};
+}
+
+/**
+ * MergeFunc for MaxNorms, keeps the vector of the smaller range on equal norms.
+ * @param result pointer to the MaxNorm to write, may be first or second
+ * @param first the MaxNorm of the smaller range
+ * @param second the MaxNorm of the greater range
+ */
+static void mergeMaxNormSummaries(void *result, const void *first, const void *second)
+{
+    const MaxNorm *firstMax = (const MaxNorm *) first;
+    const MaxNorm *secondMax = (const MaxNorm *) second;
+    MaxNorm maxNorm = secondMax->norm > firstMax->norm ? *secondMax : *firstMax;
+    *(MaxNorm *) result = maxNorm;
+}
+
+/**
+ * The augmentation that keeps the vector with the largest norm of every sub-tree.
+ */
+const RBTreeAugmentation MAX_NORM_AUGMENTATION = {.summarySize = sizeof(MaxNorm), .summarizeFunc = summarizeMaxNorm,
+                                                  .mergeFunc = mergeMaxNormSummaries, .offset = 0};
+
 /**
  * @param tree a pointer to a tree of Vectors
- * @return pointer to a *copy* of the vector that has the largest norm (L2 Norm).
+ * @return the index of MAX_NORM_AUGMENTATION in the augmentations of the tree, NO_AUGMENTATION if it has none.
  */
-Vector *findMaxNormVectorInTree(RBTree *tree) // You must use copyIfNormIsLarger in the implementation!
+static int maxNormAugmentation(const RBTree *tree)
+{
+    for (int i = STARTING_IDX; tree != NULL && i < tree->augmentationsAmount; ++i)
+    {
+        if (tree->augmentations[i].summarizeFunc == summarizeMaxNorm)
+        {
+            return i;
+        }
+    }
+    return NO_AUGMENTATION;
+}
+
+/**
+ * Sets the options of a vector tree whose nodes cache the norms of their vectors and keep the vector with the largest
+ * norm of their sub-tree, making findMaxNormVectorInTree O(1) besides the copy and findMaxNormVectorInRange
+ * O(log n).
+ * @param options the options to set (the cache and the augmentations), the other options are not changed
+ */
+void setMaxNormOptions(RBTreeOptions *options)
+{
+    options->cacheSize = sizeof(double);
+    options->cacheFunc = cacheNorm;
+    options->augmentations = &MAX_NORM_AUGMENTATION;
+    options->augmentationsAmount = MAX_NORM_AUGMENTATIONS;
+}
+
+/**
+ * @param maxNorm the vector with the largest norm, if any
+ * @return pointer to a *copy* of the vector of maxNorm, an empty vector if it has none, NULL on failure.
+ */
+static Vector *copyMaxNorm(const MaxNorm *maxNorm)
 {
     Vector *vec = (Vector *) calloc(VECTOR_AMOUNT, sizeof(Vector));
     if (vec == NULL)
     {
         return NULL;
     }
-    if (!forEachRBTree(tree, copyIfNormIsLarger, (void *) vec))
+    if (maxNorm->vec != NULL && !copyIfNormIsLarger(maxNorm->vec, (void *) vec))
     {
         freeVector((void *) vec);
         return NULL;
     }
     return vec;
 }
+
+/**
+ * @param tree a pointer to a tree of Vectors
+ * @return pointer to a *copy* of the vector that has the largest norm (L2 Norm).
+ */
+Vector *findMaxNormVectorInTree(RBTree *tree) // You must use copyIfNormIsLarger in the implementation!
+{
+    return findMaxNormVectorInTreeParallel(tree, NULL);
+}
+
+/**
+ * @param tree a pointer to a tree of Vectors
+ * @param pool the pool to search on, NULL to search on the calling thread only
+ * @return pointer to a *copy* of the vector that has the largest norm (L2 Norm), NULL on failure.
+ */
+Vector *findMaxNormVectorInTreeParallel(RBTree *tree, ForkJoinPool *pool)
+{
+    MaxNorm maxNorm = {.norm = START_VAL, .vec = NULL};
+    int augmentation = maxNormAugmentation(tree);
+    if (augmentation != NO_AUGMENTATION)
+    {
+        const MaxNorm *rootMax = (const MaxNorm *) RBTreeSummary(tree, augmentation);
+        return copyMaxNorm(rootMax != NULL ? rootMax : &maxNorm);
+    }
+    int parts = pool != NULL ? forkJoinWorkers(pool) * PARTS_PER_WORKER : ONE_PART;
+    MaxNorm *maxNorms = (MaxNorm *) calloc(parts, sizeof(MaxNorm));
+    void **partials = (void **) malloc(parts * sizeof(void *));
+    if (maxNorms == NULL || partials == NULL)
+    {
+        free(maxNorms);
+        free(partials);
+        return NULL;
+    }
+    for (int i = STARTING_IDX; i < parts; ++i)
+    {
+        partials[i] = (void *) &maxNorms[i];
+    }
+    Vector *vec = NULL;
+    int found = tree != NULL && tree->cacheFunc == cacheNorm
+                ? reduceRBTreeCachesParallel(tree, pool, keepCachedNormIfLarger, partials, parts, mergeMaxNorms)
+                : reduceRBTreeParallel(tree, pool, keepIfNormIsLarger, partials, parts, mergeMaxNorms);
+    if (found)
+    {
+        vec = copyMaxNorm(&maxNorms[STARTING_IDX]);
+    }
+    free(maxNorms);
+    free(partials);
+    return vec;
+}
+
+/**
+ * @param tree a pointer to a tree of Vectors
+ * @param lo the smallest vector of the range (it does not have to be in the tree)
+ * @param hi the greatest vector of the range (it does not have to be in the tree)
+ * @return pointer to a *copy* of the vector between lo and hi (both included) that has the largest norm, an empty
+ * vector if there is none, NULL on failure. O(log n) besides the copy for trees set by setMaxNormOptions.
+ */
+Vector *findMaxNormVectorInRange(RBTree *tree, const Vector *lo, const Vector *hi)
+{
+    MaxNorm maxNorm = {.norm = START_VAL, .vec = NULL};
+    int augmentation = maxNormAugmentation(tree);
+    if (augmentation != NO_AUGMENTATION)
+    {
+        if (!RBTreeRangeSummary(tree, augmentation, lo, hi, &maxNorm))
+        {
+            maxNorm.vec = NULL;
+        }
+    }
+    else if (!forEachRBTreeInRange(tree, lo, hi, keepIfNormIsLarger, &maxNorm))
+    {
+        return NULL;
+    }
+    return copyMaxNorm(&maxNorm);
+}
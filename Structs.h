@@ -1,74 +1,205 @@
-//
-// Created by evyat on 10/13/2019.
-//
-
-#include "RBTree.h"
-
-#ifndef TA_EX3_STRUCTS_H
-#define TA_EX3_STRUCTS_H
-
-/**
- * Represents a vector. The double* should be dynamically allocated
- */
-typedef struct Vector
-{
-	int len;
-	double *vector;
-} Vector;
-
-
-/**
- * CompFunc for strings (assumes strings end with "\0")
- * @param a - char* pointer
- * @param b - char* pointer
- * @return equal to 0 iff a == b. lower than 0 if a < b. Greater than 0 iff b < a. (lexicographic
- * order)
- */
-int stringCompare(const void *a, const void *b); // implement it in Structs.c
-
-/**
- * ForEach function that concatenates the given word and \n to pConcatenated. pConcatenated is
- * already allocated with enough space.
- * @param word - char* to add to pConcatenated
- * @param pConcatenated - char*
- * @return 0 on failure, other on success
- */
-int concatenate(const void *word, void *pConcatenated); // implement it in Structs.c
-
-/**
- * FreeFunc for strings
- */
-void freeString(void *s); // implement it in Structs.c
-
-/**
- * CompFunc for Vectors, compares element by element, the vector that has the first larger
- * element is considered larger. If vectors are of different lengths and identify for the length
- * of the shorter vector, the shorter vector is considered smaller.
- * @param a - first vector
- * @param b - second vector
- * @return equal to 0 iff a == b. lower than 0 if a < b. Greater than 0 iff b < a.
- */
-int vectorCompare1By1(const void *a, const void *b); // implement it in Structs.c
-
-/**
- * FreeFunc for vectors
- */
-void freeVector(void *pVector); // implement it in Structs.c
-
-/**
- * copy pVector to pMaxVector if : 1. The norm of pVector is greater then the norm of pMaxVector.
- * 								   2. pMaxVector->vector == NULL.
- * @param pVector pointer to Vector
- * @param pMaxVector pointer to Vector
- * @return 1 on success, 0 on failure (if pVector == NULL: failure).
- */
-int copyIfNormIsLarger(const void *pVector, void *pMaxVector); // implement it in Structs.c
-
-/**
- * @param tree a pointer to a tree of Vectors
- * @return pointer to a *copy* of the vector that has the largest norm (L2 Norm).
- */
-Vector *findMaxNormVectorInTree(RBTree *tree); // implement it in Structs.c You must use copyIfNormIsLarger in the implementation!
-
-
-#endif //TA_EX3_STRUCTS_H
+//
+// Created by evyat on 10/13/2019.
+//
+
+#include "RBTreeParallel.h"
+#include "RBTreeTemplate.h"
+
+#ifndef TA_EX3_STRUCTS_H
+#define TA_EX3_STRUCTS_H
+
+/**
+ * Represents a vector. The double* should be dynamically allocated
+ */
+typedef struct Vector
+{
+	int len;
+	double *vector;
+} Vector;
+
+
+/**
+ * An accumulator of a string that grows at its end. Appending costs only the length of the appended string, unlike
+ * strcat that rescans the string from its start.
+ */
+typedef struct StringBuilder
+{
+	char *string; // null terminated.
+	size_t length;
+	size_t capacity; // characters that fit without growing, the null terminator not included.
+} StringBuilder;
+
+/**
+ * CompFunc for strings (assumes strings end with "\0")
+ * @param a - char* pointer
+ * @param b - char* pointer
+ * @return equal to 0 iff a == b. lower than 0 if a < b. Greater than 0 iff b < a. (lexicographic
+ * order)
+ */
+int stringCompare(const void *a, const void *b); // implement it in Structs.c
+
+/**
+ * PrefixFunc for strings: the first 8 characters as a big-endian number, padded with zeros, so it sorts like
+ * stringCompare.
+ * @param s - char* pointer
+ * @return the prefix of the string
+ */
+uint64_t stringPrefix(const void *s);
+
+/**
+ * ForEach function that concatenates the given word and \n to pConcatenated. pConcatenated is
+ * already allocated with enough space.
+ * @param word - char* to add to pConcatenated
+ * @param pConcatenated - char*
+ * @return 0 on failure, other on success
+ */
+int concatenate(const void *word, void *pConcatenated); // implement it in Structs.c
+
+/**
+ * FreeFunc for strings
+ */
+void freeString(void *s); // implement it in Structs.c
+
+/**
+ * Initializes an empty StringBuilder.
+ * @param builder the builder to initialize
+ * @param capacity the amount of characters to make room for (more are appended by growing the buffer)
+ * @return 1 on success, 0 on failure
+ */
+int initStringBuilder(StringBuilder *builder, size_t capacity);
+
+/**
+ * ForEach function that appends the given word to a StringBuilder, growing its buffer if needed.
+ * @param word - char* to append
+ * @param pBuilder - StringBuilder*
+ * @return 0 on failure, other on success
+ */
+int appendString(const void *word, void *pBuilder);
+
+/**
+ * ForEach function that adds the length of the given word to a total, to size a StringBuilder exactly.
+ * @param word - char*
+ * @param pLength - size_t* of the total
+ * @return 0 on failure, other on success
+ */
+int addStringLength(const void *word, void *pLength);
+
+/**
+ * Frees the buffer of a StringBuilder.
+ * @param builder the builder to free
+ */
+void freeStringBuilder(StringBuilder *builder);
+
+/**
+ * Concatenates the strings of a tree by order, like forEachRBTree with concatenate, in time linear in the total
+ * length. The total length is found first, so the result is allocated once and exactly.
+ * @param tree a pointer to a tree of strings
+ * @return the concatenation, to free with freeString, NULL on failure.
+ */
+char *concatenateTree(const RBTree *tree);
+
+/**
+ * Constructs a tree of strings that stores its strings in a StringArena it owns, instead of allocating each one.
+ * Equal strings share one copy, and freeing the tree frees all of them at once. The strings of deleted items stay in
+ * the arena until the tree (and the trees made like it) are freed.
+ * @param options the features of the tree, NULL for the defaults of newRBTree
+ * @return the new tree, NULL on failure
+ */
+RBTree *newStringArenaRBTree(const RBTreeOptions *options);
+
+/**
+ * Copies a string into the arena of a tree made by newStringArenaRBTree and adds the copy to the tree.
+ * @param tree a tree made by newStringArenaRBTree (or like one)
+ * @param string the string to add, stays owned by the caller
+ * @return 0 on failure, other on success (if the string is already in the tree - failure)
+ */
+int insertStringToRBTree(RBTree *tree, const char *string);
+
+/**
+ * CompFunc for Vectors, compares element by element, the vector that has the first larger
+ * element is considered larger. If vectors are of different lengths and identify for the length
+ * of the shorter vector, the shorter vector is considered smaller.
+ * @param a - first vector
+ * @param b - second vector
+ * @return equal to 0 iff a == b. lower than 0 if a < b. Greater than 0 iff b < a.
+ */
+int vectorCompare1By1(const void *a, const void *b); // implement it in Structs.c
+
+/**
+ * PrefixFunc for Vectors: the bits of the first coordinate, reordered to sort like the coordinate, 0 for an empty
+ * vector. Vectors whose first coordinate is NaN do not sort consistently by vectorCompare1By1, and must not be used.
+ * @param v - Vector* pointer
+ * @return the prefix of the vector
+ */
+uint64_t vectorPrefix(const void *v);
+
+/**
+ * Trees of Vectors ordered by vectorCompare1By1, and of strings ordered by stringCompare, whose searches call the
+ * comparison directly (see RBTreeTemplate.h).
+ */
+RBTREE_DECLARE(vectorTree, Vector);
+
+RBTREE_DECLARE(stringTree, char);
+
+/**
+ * FreeFunc for vectors
+ */
+void freeVector(void *pVector); // implement it in Structs.c
+
+/**
+ * CacheFunc for Vectors, keeps the norm of the vector (a double) so it is computed once, when the vector is added.
+ * use with a cacheSize of sizeof(double). findMaxNormVectorInTree reads the cached norms of such trees.
+ * @param pVector pointer to Vector
+ * @param pNorm pointer to the double to write the norm to
+ */
+void cacheNorm(const void *pVector, void *pNorm);
+
+/**
+ * The augmentation that keeps the vector with the largest norm of every sub-tree, to combine with other
+ * augmentations of a vector tree. the tree must cache its items with cacheNorm, or keep no cache.
+ */
+extern const RBTreeAugmentation MAX_NORM_AUGMENTATION;
+
+/**
+ * Sets the options of a vector tree whose nodes cache the norms of their vectors and keep the vector with the largest
+ * norm of their sub-tree, making findMaxNormVectorInTree O(1) besides the copy and findMaxNormVectorInRange
+ * O(log n).
+ * @param options the options to set (the cache and the augmentations), the other options are not changed
+ */
+void setMaxNormOptions(RBTreeOptions *options);
+
+/**
+ * copy pVector to pMaxVector if : 1. The norm of pVector is greater then the norm of pMaxVector.
+ * 								   2. pMaxVector->vector == NULL.
+ * @param pVector pointer to Vector
+ * @param pMaxVector pointer to Vector
+ * @return 1 on success, 0 on failure (if pVector == NULL: failure).
+ */
+int copyIfNormIsLarger(const void *pVector, void *pMaxVector); // implement it in Structs.c
+
+/**
+ * @param tree a pointer to a tree of Vectors
+ * @return pointer to a *copy* of the vector that has the largest norm (L2 Norm).
+ */
+Vector *findMaxNormVectorInTree(RBTree *tree); // implement it in Structs.c You must use copyIfNormIsLarger in the implementation!
+
+/**
+ * @param tree a pointer to a tree of Vectors
+ * @param pool the pool to search on, NULL to search on the calling thread only. each worker keeps the largest norm of
+ * its parts of the tree, reading the norms the tree caches if it was made with setMaxNormOptions, and only the
+ * largest of all is copied.
+ * @return pointer to a *copy* of the vector that has the largest norm (L2 Norm), NULL on failure.
+ */
+Vector *findMaxNormVectorInTreeParallel(RBTree *tree, ForkJoinPool *pool);
+
+/**
+ * @param tree a pointer to a tree of Vectors
+ * @param lo the smallest vector of the range (it does not have to be in the tree)
+ * @param hi the greatest vector of the range (it does not have to be in the tree)
+ * @return pointer to a *copy* of the vector between lo and hi (both included) that has the largest norm, an empty
+ * vector if there is none, NULL on failure. O(log n) besides the copy for trees set by setMaxNormOptions.
+ */
+Vector *findMaxNormVectorInRange(RBTree *tree, const Vector *lo, const Vector *hi);
+
+
+#endif //TA_EX3_STRUCTS_H
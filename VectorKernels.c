@@ -0,0 +1,242 @@
+/**
+ * @file VectorKernels.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 22 may 2020
+ *
+ * @brief Loops over the coordinates of vectors, with SIMD versions.
+ *
+ * @section DESCRIPTION
+ * Holds the scalar, AVX2 and AVX-512 versions of the vector loops. The vector versions are compiled with target
+ * attributes, so the file needs no special flags, and are only called on processors that support them. The version
+ * is chosen once, when the program is loaded, and called through a function pointer.
+ */
+// ------------------------------ includes ------------------------------
+#include "VectorKernels.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_DISPATCH (1)
+#include <immintrin.h>
+#else
+#define SIMD_DISPATCH (0)
+#endif
+// -------------------------- const definitions -------------------------
+#define START_VAL (0)
+
+#define AVX2_LANES (4)
+#define AVX512_LANES (8)
+
+#define FAILURE (0)
+#define SUCCESS (1)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief The scalar version of sumOfSquares.
+ */
+static double sumOfSquaresScalar(const double *coords, int len)
+{
+    double sum = START_VAL;
+    for (int i = START_VAL; i < len; ++i)
+    {
+        sum += coords[i] * coords[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief The scalar version of firstDifference, from a given index on.
+ */
+static int firstDifferenceScalar(const double *a, const double *b, int from, int len)
+{
+    for (int i = from; i < len; ++i)
+    {
+        if (a[i] < b[i] || a[i] > b[i])
+        {
+            return i;
+        }
+    }
+    return len;
+}
+
+/**
+ * @brief The scalar version of firstDifference.
+ */
+static int firstDifferenceFromStart(const double *a, const double *b, int len)
+{
+    return firstDifferenceScalar(a, b, START_VAL, len);
+}
+
+/**
+ * The versions of the loops that sumOfSquares and firstDifference call. They are the scalar ones until the program is
+ * loaded, or if the processor supports no other.
+ */
+static double (*sumOfSquaresKernel)(const double *coords, int len) = sumOfSquaresScalar;
+static int (*firstDifferenceKernel)(const double *a, const double *b, int len) = firstDifferenceFromStart;
+
+#if SIMD_DISPATCH
+/**
+ * @brief The AVX2 version of sumOfSquares, with two accumulators to hide the latency of the additions.
+ */
+__attribute__((target("avx2"))) static double sumOfSquaresAvx2(const double *coords, int len)
+{
+    __m256d first = _mm256_setzero_pd(), second = _mm256_setzero_pd();
+    int i = START_VAL;
+    for (; i + 2 * AVX2_LANES <= len; i += 2 * AVX2_LANES)
+    {
+        __m256d x = _mm256_loadu_pd(coords + i), y = _mm256_loadu_pd(coords + i + AVX2_LANES);
+        first = _mm256_add_pd(first, _mm256_mul_pd(x, x));
+        second = _mm256_add_pd(second, _mm256_mul_pd(y, y));
+    }
+    for (; i + AVX2_LANES <= len; i += AVX2_LANES)
+    {
+        __m256d x = _mm256_loadu_pd(coords + i);
+        first = _mm256_add_pd(first, _mm256_mul_pd(x, x));
+    }
+    first = _mm256_add_pd(first, second);
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(first), _mm256_extractf128_pd(first, 1));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+    return sum + sumOfSquaresScalar(coords + i, len - i);
+}
+
+/**
+ * @brief The AVX2 version of firstDifference: compares four coordinates at once, and finds the first different one
+ * of a block by its bit in the mask of the comparison.
+ */
+__attribute__((target("avx2"))) static int firstDifferenceAvx2(const double *a, const double *b, int len)
+{
+    int i = START_VAL;
+    for (; i + AVX2_LANES <= len; i += AVX2_LANES)
+    {
+        __m256d differ = _mm256_cmp_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), _CMP_NEQ_OQ);
+        int mask = _mm256_movemask_pd(differ);
+        if (mask != START_VAL)
+        {
+            return i + __builtin_ctz((unsigned) mask);
+        }
+    }
+    return firstDifferenceScalar(a, b, i, len);
+}
+
+/**
+ * @brief The AVX-512 version of sumOfSquares. The tail is loaded with a mask, so there is no scalar loop.
+ */
+__attribute__((target("avx512f"))) static double sumOfSquaresAvx512(const double *coords, int len)
+{
+    __m512d first = _mm512_setzero_pd(), second = _mm512_setzero_pd();
+    int i = START_VAL;
+    for (; i + 2 * AVX512_LANES <= len; i += 2 * AVX512_LANES)
+    {
+        __m512d x = _mm512_loadu_pd(coords + i), y = _mm512_loadu_pd(coords + i + AVX512_LANES);
+        first = _mm512_fmadd_pd(x, x, first);
+        second = _mm512_fmadd_pd(y, y, second);
+    }
+    for (; i < len; i += AVX512_LANES)
+    {
+        int rest = len - i < AVX512_LANES ? len - i : AVX512_LANES;
+        __m512d x = _mm512_maskz_loadu_pd((__mmask8) ((1u << rest) - 1), coords + i);
+        first = _mm512_fmadd_pd(x, x, first);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(first, second));
+}
+
+/**
+ * @brief The AVX-512 version of firstDifference: compares eight coordinates at once into a mask register, the tail
+ * with a masked load.
+ */
+__attribute__((target("avx512f"))) static int firstDifferenceAvx512(const double *a, const double *b, int len)
+{
+    int i = START_VAL;
+    for (; i + AVX512_LANES <= len; i += AVX512_LANES)
+    {
+        __mmask8 differ = _mm512_cmp_pd_mask(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), _CMP_NEQ_OQ);
+        if (differ != START_VAL)
+        {
+            return i + __builtin_ctz((unsigned) differ);
+        }
+    }
+    if (i < len)
+    {
+        __mmask8 lanes = (__mmask8) ((1u << (len - i)) - 1);
+        __mmask8 differ = _mm512_mask_cmp_pd_mask(lanes, _mm512_maskz_loadu_pd(lanes, a + i),
+                                                  _mm512_maskz_loadu_pd(lanes, b + i), _CMP_NEQ_OQ);
+        if (differ != START_VAL)
+        {
+            return i + __builtin_ctz((unsigned) differ);
+        }
+    }
+    return len;
+}
+#endif
+
+/**
+ * makes sumOfSquares and firstDifference use one version of the loops, for example the scalar one, whose sums are
+ * the same on every machine. by default they use the best version the processor supports. it must not be called
+ * while other threads use the loops.
+ * @param kernels: the version to use.
+ * @return: 1 on success, 0 if the compiler or the processor does not support the version (nothing is changed).
+ */
+int useVectorKernels(VectorKernels kernels)
+{
+    switch (kernels)
+    {
+        case SCALAR_KERNELS:
+            sumOfSquaresKernel = sumOfSquaresScalar;
+            firstDifferenceKernel = firstDifferenceFromStart;
+            return SUCCESS;
+#if SIMD_DISPATCH
+        case AVX2_KERNELS:
+            if (!__builtin_cpu_supports("avx2"))
+            {
+                return FAILURE;
+            }
+            sumOfSquaresKernel = sumOfSquaresAvx2;
+            firstDifferenceKernel = firstDifferenceAvx2;
+            return SUCCESS;
+        case AVX512_KERNELS:
+            if (!__builtin_cpu_supports("avx512f"))
+            {
+                return FAILURE;
+            }
+            sumOfSquaresKernel = sumOfSquaresAvx512;
+            firstDifferenceKernel = firstDifferenceAvx512;
+            return SUCCESS;
+#endif
+        default:
+            return FAILURE;
+    }
+}
+
+#if SIMD_DISPATCH
+/**
+ * @brief Chooses the best version of the loops the processor supports, once, when the program is loaded.
+ */
+__attribute__((constructor)) static void selectVectorKernels(void)
+{
+    __builtin_cpu_init();
+    if (!useVectorKernels(AVX512_KERNELS))
+    {
+        useVectorKernels(AVX2_KERNELS);
+    }
+}
+#endif
+
+/**
+ * @param coords: the coordinates of a vector.
+ * @param len: the amount of coordinates.
+ * @return: the sum of the squares of the coordinates. the vector versions add in a different order than the scalar
+ * one, so the last bits may differ between machines (but not between calls on one machine).
+ */
+double sumOfSquares(const double *coords, int len)
+{
+    return sumOfSquaresKernel(coords, len);
+}
+
+/**
+ * @param a: the coordinates of a vector.
+ * @param b: the coordinates of another vector.
+ * @param len: the amount of coordinates to compare.
+ * @return: the first index in which a coordinate of a is smaller or greater than that of b, len if there is none
+ * (coordinates that are NaN are neither).
+ */
+int firstDifference(const double *a, const double *b, int len)
+{
+    return firstDifferenceKernel(a, b, len);
+}
@@ -0,0 +1,45 @@
+#ifndef RBTREE_VECTORKERNELS_H
+#define RBTREE_VECTORKERNELS_H
+
+/**
+ * the loops over the coordinates of vectors. each has an AVX-512 and an AVX2 version on x86 compilers that support
+ * them, chosen once when the program is loaded by what the processor supports, and a scalar version for everything
+ * else.
+ */
+
+/**
+ * the versions of the loops.
+ */
+typedef enum VectorKernels
+{
+	SCALAR_KERNELS, AVX2_KERNELS, AVX512_KERNELS
+} VectorKernels;
+
+/**
+ * @param coords: the coordinates of a vector.
+ * @param len: the amount of coordinates.
+ * @return: the sum of the squares of the coordinates. the vector versions add in a different order than the scalar
+ * one, so the last bits may differ between machines (but not between calls on one machine).
+ */
+double sumOfSquares(const double *coords, int len);
+
+/**
+ * @param a: the coordinates of a vector.
+ * @param b: the coordinates of another vector.
+ * @param len: the amount of coordinates to compare.
+ * @return: the first index in which a coordinate of a is smaller or greater than that of b, len if there is none
+ * (coordinates that are NaN are neither).
+ */
+int firstDifference(const double *a, const double *b, int len);
+
+/**
+ * makes sumOfSquares and firstDifference use one version of the loops, for example the scalar one, whose sums are
+ * the same on every machine. by default they use the best version the processor supports. it must not be called
+ * while other threads use the loops.
+ * @param kernels: the version to use.
+ * @return: 1 on success, 0 if the compiler or the processor does not support the version (nothing is changed).
+ */
+int useVectorKernels(VectorKernels kernels);
+
+
+#endif //RBTREE_VECTORKERNELS_H
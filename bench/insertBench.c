@@ -0,0 +1,277 @@
+/**
+ * @file insertBench.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Measures the insertion throughput of RBTree, before and after the iterative insert fix-up.
+ *
+ * @section DESCRIPTION
+ * Inserts random 64 bit keys (10M by default, or the amount given as the first argument) into a tree and prints the
+ * amount of inserts per second. The same keys are first inserted into a copy of the original insertion, that
+ * rebalances by calling updateColors recursively up the tree, so the two rates are compared on one machine. Build
+ * with:
+ * gcc -O2 -pthread -I. bench/insertBench.c RBTree.c -o insertBench
+ */
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 199309L
+
+#include "RBTree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+// -------------------------- const definitions -------------------------
+#define DEFAULT_KEYS (10000000ul)
+
+#define SEED (0x9E3779B97F4A7C15ull)
+
+#define NANO (1e-9)
+
+#define LEFT (-1)
+#define NO_SIDE (0)
+#define RIGHT (1)
+// ------------------------------ structs -------------------------------
+/**
+ * a node of the original insertion, with its own parent and color fields.
+ */
+typedef struct BaselineNode
+{
+    struct BaselineNode *parent, *left, *right;
+    void *data;
+    Color color;
+} BaselineNode;
+
+/**
+ * a tree of the original insertion.
+ */
+typedef struct BaselineTree
+{
+    BaselineNode *root;
+    CompareFunc compFunc;
+    long unsigned size;
+} BaselineTree;
+// ------------------------------ functions -----------------------------
+/**
+ * @brief CompareFunc for keys of type uint64_t.
+ */
+int keyCompare(const void *a, const void *b)
+{
+    uint64_t keyA = *(const uint64_t *) a;
+    uint64_t keyB = *(const uint64_t *) b;
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+/**
+ * @brief FreeFunc for keys that are owned by the benchmark and not by the tree.
+ */
+void keepKey(void *key)
+{
+    (void) key;
+}
+
+/**
+ * @param state The state of the generator, advanced by the call.
+ * @return The next pseudo random number of a splitmix64 sequence.
+ */
+uint64_t nextRandom(uint64_t *state)
+{
+    uint64_t z = (*state += SEED);
+    z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31u);
+}
+
+/**
+ * @param child A node of the baseline tree.
+ * @return 0 if it has no parent, -1 if it is a left child, 1 if it is a right child.
+ */
+int baselineSide(const BaselineNode *child)
+{
+    if (child == NULL || child->parent == NULL)
+    {
+        return NO_SIDE;
+    }
+    return child == child->parent->left ? LEFT : RIGHT;
+}
+
+/**
+ * @brief Connects child to a side of parent, or makes it the root if parent is NULL.
+ */
+void baselineConnect(BaselineTree *tree, BaselineNode *parent, BaselineNode *child, int side)
+{
+    if (parent == NULL)
+    {
+        tree->root = child;
+    }
+    else if (side == LEFT)
+    {
+        parent->left = child;
+    }
+    else
+    {
+        parent->right = child;
+    }
+    if (child != NULL)
+    {
+        child->parent = parent;
+    }
+}
+
+/**
+ * @brief Rotates a sub-tree so that the child becomes the parent.
+ */
+void baselineRotate(BaselineTree *tree, BaselineNode *child, BaselineNode *parent)
+{
+    int childSide = baselineSide(child);
+    baselineConnect(tree, parent->parent, child, baselineSide(parent));
+    if (childSide == LEFT)
+    {
+        baselineConnect(tree, parent, child->right, LEFT);
+        baselineConnect(tree, child, parent, RIGHT);
+    }
+    else
+    {
+        baselineConnect(tree, parent, child->left, RIGHT);
+        baselineConnect(tree, child, parent, LEFT);
+    }
+}
+
+/**
+ * @brief Fixes a red node with a red parent and a black uncle, by one or two rotations.
+ * @return The color of node.
+ */
+Color baselineBlackUncle(BaselineTree *tree, BaselineNode *gParent, BaselineNode *parent, BaselineNode *node,
+                         int parentSide)
+{
+    if (baselineSide(node) != parentSide)
+    {
+        baselineRotate(tree, node, parent);
+        parent = node;
+    }
+    baselineRotate(tree, parent, gParent);
+    parent->color = BLACK, gParent->color = RED;
+    return node == parent ? BLACK : RED;
+}
+
+/**
+ * @brief The original fix-up: recolors a red uncle and recurses from the grand parent.
+ * @return The color of node.
+ */
+Color baselineUpdateColors(BaselineTree *tree, BaselineNode *node)
+{
+    BaselineNode *parent = node->parent;
+    if (parent == NULL)
+    {
+        return BLACK;
+    }
+    if (parent->color == BLACK)
+    {
+        return RED;
+    }
+    BaselineNode *gParent = parent->parent;
+    int parentSide = baselineSide(parent);
+    BaselineNode *uncle = parentSide == LEFT ? gParent->right : gParent->left;
+    if (uncle == NULL || uncle->color == BLACK)
+    {
+        return baselineBlackUncle(tree, gParent, parent, node, parentSide);
+    }
+    parent->color = BLACK, uncle->color = BLACK;
+    gParent->color = baselineUpdateColors(tree, gParent);
+    return RED;
+}
+
+/**
+ * @brief The original insertion: allocates a node, descends to its place and calls baselineUpdateColors.
+ * @return 0 on failure, other on success.
+ */
+int baselineInsert(BaselineTree *tree, void *data)
+{
+    BaselineNode *node = (BaselineNode *) malloc(sizeof(BaselineNode));
+    if (node == NULL)
+    {
+        return 0;
+    }
+    *node = (BaselineNode) {.parent = NULL, .left = NULL, .right = NULL, .data = data, .color = BLACK};
+    BaselineNode *cur = tree->root, *parent = NULL;
+    int side = NO_SIDE;
+    while (cur != NULL)
+    {
+        int compRes = tree->compFunc(data, cur->data);
+        if (compRes == 0)
+        {
+            free(node);
+            return 0;
+        }
+        parent = cur;
+        side = compRes < 0 ? LEFT : RIGHT;
+        cur = compRes < 0 ? cur->left : cur->right;
+    }
+    baselineConnect(tree, parent, node, side);
+    node->color = baselineUpdateColors(tree, node);
+    (tree->size)++;
+    return 1;
+}
+
+/**
+ * @brief Frees a sub-tree of the baseline tree, without its items.
+ */
+void baselineFree(BaselineNode *node)
+{
+    if (node == NULL)
+    {
+        return;
+    }
+    baselineFree(node->left);
+    baselineFree(node->right);
+    free(node);
+}
+
+/**
+ * @return The current time of a monotonic clock, in seconds.
+ */
+double now(void)
+{
+    struct timespec spec;
+    clock_gettime(CLOCK_MONOTONIC, &spec);
+    return (double) spec.tv_sec + (double) spec.tv_nsec * NANO;
+}
+
+int main(int argc, char *argv[])
+{
+    long unsigned amount = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_KEYS;
+    uint64_t *keys = (uint64_t *) malloc(amount * sizeof(uint64_t));
+    RBTree *tree = newRBTree(keyCompare, keepKey);
+    if (keys == NULL || tree == NULL)
+    {
+        fprintf(stderr, "allocation failed\n");
+        return EXIT_FAILURE;
+    }
+    uint64_t state = amount;
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        keys[i] = nextRandom(&state);
+    }
+    BaselineTree baseline = {.root = NULL, .compFunc = keyCompare, .size = 0};
+    double start = now();
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        baselineInsert(&baseline, keys + i);
+    }
+    double baselineSeconds = now() - start;
+    baselineFree(baseline.root);
+    start = now();
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        insertToRBTree(tree, keys + i);
+    }
+    double seconds = now() - start;
+    printf("recursive updateColors: %lu inserts in %.3f s: %.0f inserts/sec\n", amount, baselineSeconds,
+           (double) amount / baselineSeconds);
+    printf("iterative fix-up:       %lu inserts in %.3f s: %.0f inserts/sec\n", amount, seconds,
+           (double) amount / seconds);
+    printf("speedup: %.2fx\n", baselineSeconds / seconds);
+    freeRBTree(&tree);
+    free(keys);
+    return EXIT_SUCCESS;
+}
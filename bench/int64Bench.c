@@ -0,0 +1,164 @@
+/**
+ * @file int64Bench.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Compares a tree of allocated int64_t items with an int64Tree that keeps the keys in its nodes.
+ *
+ * @section DESCRIPTION
+ * Inserts random keys (1M by default, or the amount given as the first argument) into both trees, looks all of them
+ * up and deletes them, and prints the time of every phase. The generic tree allocates every key on its own and
+ * compares through its CompareFunc, as a tree of int64_t items does without int64Tree. A second argument sets
+ * RBTreeOptions.poolSlabNodes of both trees. Build with:
+ * gcc -O2 -I. bench/int64Bench.c Int64RBTree.c RBTree.c -o int64Bench
+ */
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 199309L
+
+#include "Int64RBTree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+// -------------------------- const definitions -------------------------
+#define DEFAULT_KEYS (1000000ul)
+
+#define SEED (0x9E3779B97F4A7C15ull)
+
+#define NANO (1e-9)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief CompareFunc for items of type int64_t.
+ */
+int int64Compare(const void *a, const void *b)
+{
+    int64_t keyA = *(const int64_t *) a;
+    int64_t keyB = *(const int64_t *) b;
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+/**
+ * @param state The state of the generator, advanced by the call.
+ * @return The next pseudo random number of a splitmix64 sequence.
+ */
+uint64_t nextRandom(uint64_t *state)
+{
+    uint64_t z = (*state += SEED);
+    z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31u);
+}
+
+/**
+ * @return The current time of a monotonic clock, in seconds.
+ */
+double now(void)
+{
+    struct timespec spec;
+    clock_gettime(CLOCK_MONOTONIC, &spec);
+    return (double) spec.tv_sec + (double) spec.tv_nsec * NANO;
+}
+
+/**
+ * @brief Inserts, finds and deletes the keys in a tree of allocated items, and prints the time of every phase.
+ * @return 1 on success, 0 if an allocation failed.
+ */
+int benchGeneric(const int64_t *keys, long unsigned amount, const RBTreeOptions *options)
+{
+    RBTree *tree = newRBTreeWithOptions(int64Compare, free, options);
+    if (tree == NULL)
+    {
+        return 0;
+    }
+    double start = now();
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        int64_t *item = (int64_t *) malloc(sizeof(int64_t));
+        if (item == NULL)
+        {
+            freeRBTree(&tree);
+            return 0;
+        }
+        *item = keys[i];
+        if (!insertToRBTree(tree, item))
+        {
+            free(item);
+        }
+    }
+    double inserted = now();
+    long unsigned found = 0;
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        found += RBTreeContains(tree, keys + i);
+    }
+    double looked = now();
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        deleteFromRBTree(tree, (void *) (keys + i));
+    }
+    double deleted = now();
+    printf("generic:   insert %.3f s, lookup %.3f s, delete %.3f s (%lu found)\n", inserted - start,
+           looked - inserted, deleted - looked, found);
+    freeRBTree(&tree);
+    return 1;
+}
+
+/**
+ * @brief Inserts, finds and deletes the keys in an int64Tree, and prints the time of every phase.
+ * @return 1 on success, 0 if an allocation failed.
+ */
+int benchInt64Tree(const int64_t *keys, long unsigned amount, const RBTreeOptions *options)
+{
+    RBTree *tree = int64TreeNew(options);
+    if (tree == NULL)
+    {
+        return 0;
+    }
+    double start = now();
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        int64TreeInsert(tree, keys[i]);
+    }
+    double inserted = now();
+    long unsigned found = 0;
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        found += int64TreeContains(tree, keys[i]);
+    }
+    double looked = now();
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        int64TreeDelete(tree, keys[i]);
+    }
+    double deleted = now();
+    printf("int64Tree: insert %.3f s, lookup %.3f s, delete %.3f s (%lu found)\n", inserted - start,
+           looked - inserted, deleted - looked, found);
+    freeRBTree(&tree);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    long unsigned amount = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_KEYS;
+    RBTreeOptions options = {.poolSlabNodes = argc > 2 ? strtoul(argv[2], NULL, 10) : 0};
+    int64_t *keys = (int64_t *) malloc(amount * sizeof(int64_t));
+    if (keys == NULL)
+    {
+        fprintf(stderr, "allocation failed\n");
+        return EXIT_FAILURE;
+    }
+    uint64_t state = amount;
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        keys[i] = (int64_t) nextRandom(&state);
+    }
+    if (!benchGeneric(keys, amount, &options) || !benchInt64Tree(keys, amount, &options))
+    {
+        fprintf(stderr, "allocation failed\n");
+        free(keys);
+        return EXIT_FAILURE;
+    }
+    free(keys);
+    return EXIT_SUCCESS;
+}
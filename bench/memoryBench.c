@@ -0,0 +1,91 @@
+/**
+ * @file memoryBench.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Measures the memory RBTree takes per item.
+ *
+ * @section DESCRIPTION
+ * Inserts keys (100M by default, or the amount given as the first argument) into a tree and prints the growth of the
+ * resident set per item. A second argument sets RBTreeOptions.poolSlabNodes. Linux only (reads /proc/self/statm).
+ * Build with:
+ * gcc -O2 -I. bench/memoryBench.c RBTree.c -o memoryBench
+ */
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 200112L
+
+#include "RBTree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+// -------------------------- const definitions -------------------------
+#define DEFAULT_KEYS (100000000ul)
+
+#define STATM_PATH "/proc/self/statm"
+// ------------------------------ functions -----------------------------
+/**
+ * @brief CompareFunc for keys of type uint64_t.
+ */
+int keyCompare(const void *a, const void *b)
+{
+    uint64_t keyA = *(const uint64_t *) a;
+    uint64_t keyB = *(const uint64_t *) b;
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+/**
+ * @brief FreeFunc for keys that are owned by the benchmark and not by the tree.
+ */
+void keepKey(void *key)
+{
+    (void) key;
+}
+
+/**
+ * @return The resident set size of the process in bytes, 0 on failure.
+ */
+long unsigned residentBytes(void)
+{
+    long unsigned size, resident = 0;
+    FILE *statm = fopen(STATM_PATH, "r");
+    if (statm == NULL)
+    {
+        return 0;
+    }
+    if (fscanf(statm, "%lu %lu", &size, &resident) != 2)
+    {
+        resident = 0;
+    }
+    fclose(statm);
+    return resident * (long unsigned) sysconf(_SC_PAGESIZE);
+}
+
+int main(int argc, char *argv[])
+{
+    long unsigned amount = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_KEYS;
+    RBTreeOptions options = {.poolSlabNodes = argc > 2 ? strtoul(argv[2], NULL, 10) : 0};
+    uint64_t *keys = (uint64_t *) malloc(amount * sizeof(uint64_t));
+    RBTree *tree = newRBTreeWithOptions(keyCompare, keepKey, &options);
+    if (keys == NULL || tree == NULL)
+    {
+        fprintf(stderr, "allocation failed\n");
+        return EXIT_FAILURE;
+    }
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        keys[i] = i;
+    }
+    long unsigned before = residentBytes();
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        insertToRBTree(tree, keys + i);
+    }
+    long unsigned after = residentBytes();
+    printf("%lu items, sizeof(Node) = %zu: %.2f bytes/node\n", amount, sizeof(Node),
+           (double) (after - before) / (double) amount);
+    freeRBTree(&tree);
+    free(keys);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file prefixBench.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Counts the CompareFunc calls of a tree of strings with and without a PrefixFunc.
+ *
+ * @section DESCRIPTION
+ * Inserts random strings (200K by default, or the amount given as the first argument) into a tree, looks all of them
+ * up, walks the range from each of the first RANGES of them up to the end of their first RANGE_LENGTH random
+ * characters, and deletes them, once without a PrefixFunc and once with one that packs the first 8
+ * characters. Prints the calls of the CompareFunc and the time of every phase. The strings start with a common
+ * prefix of COMMON_LENGTH characters (none by default, or the second argument), so a larger one shows where the
+ * prefixes stop helping. Build with:
+ * gcc -O2 -I. bench/prefixBench.c RBTree.c -o prefixBench
+ */
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 199309L
+
+#include "RBTree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+// -------------------------- const definitions -------------------------
+#define DEFAULT_STRINGS (200000ul)
+
+#define RANDOM_LENGTH (16)
+
+#define LETTERS (26)
+
+#define PREFIX_BYTES (8)
+
+#define BITS_IN_BYTE (8)
+
+#define RANGES (10000)
+
+#define RANGE_LENGTH (3)
+
+#define AFTER_LETTERS ('z' + 1)
+
+#define SEED (0x9E3779B97F4A7C15ull)
+
+#define NANO (1e-9)
+// ------------------------------ functions -----------------------------
+/**
+ * The amount of calls of countedCompare.
+ */
+static long unsigned compareCalls = 0;
+
+/**
+ * @brief CompareFunc for strings that counts its calls.
+ */
+int countedCompare(const void *a, const void *b)
+{
+    compareCalls++;
+    return strcmp((const char *) a, (const char *) b);
+}
+
+/**
+ * @brief PrefixFunc for strings: their first 8 characters as a big endian number.
+ */
+uint64_t packedPrefix(const void *object)
+{
+    const unsigned char *str = (const unsigned char *) object;
+    uint64_t prefix = 0;
+    int i = 0;
+    for (; i < PREFIX_BYTES && str[i] != '\0'; ++i)
+    {
+        prefix = prefix << BITS_IN_BYTE | str[i];
+    }
+    return prefix << (BITS_IN_BYTE * (PREFIX_BYTES - i)) % (BITS_IN_BYTE * PREFIX_BYTES);
+}
+
+/**
+ * @brief forEachFunc that counts the items it visits.
+ */
+int countItem(const void *object, void *count)
+{
+    (void) object;
+    (*(long unsigned *) count)++;
+    return 1;
+}
+
+/**
+ * @param state The state of the generator, advanced by the call.
+ * @return The next pseudo random number of a splitmix64 sequence.
+ */
+uint64_t nextRandom(uint64_t *state)
+{
+    uint64_t z = (*state += SEED);
+    z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31u);
+}
+
+/**
+ * @return The current time of a monotonic clock, in seconds.
+ */
+double now(void)
+{
+    struct timespec spec;
+    clock_gettime(CLOCK_MONOTONIC, &spec);
+    return (double) spec.tv_sec + (double) spec.tv_nsec * NANO;
+}
+
+/**
+ * @brief Runs the phases on a tree made with the given options, and prints the calls and the time of each.
+ * @return 1 on success, 0 if an allocation failed.
+ */
+int benchTree(const char *name, char **strings, long unsigned amount, int common, const RBTreeOptions *options)
+{
+    RBTree *tree = newRBTreeWithOptions(countedCompare, NULL, options);
+    char *hi = (char *) malloc(common + RANDOM_LENGTH + 1);
+    if (tree == NULL || hi == NULL)
+    {
+        freeRBTree(&tree);
+        free(hi);
+        return 0;
+    }
+    const char *phases[] = {"insert", "lookup", "ranges", "delete"};
+    long unsigned calls[4];
+    double times[4];
+    long unsigned found = 0, walked = 0;
+    for (int phase = 0; phase < 4; ++phase)
+    {
+        compareCalls = 0;
+        double start = now();
+        for (long unsigned i = 0; i < amount; ++i)
+        {
+            if (phase == 0)
+            {
+                insertToRBTree(tree, strings[i]);
+            }
+            else if (phase == 1)
+            {
+                found += RBTreeContains(tree, strings[i]);
+            }
+            else if (phase == 2 && i < RANGES)
+            {
+                memcpy(hi, strings[i], common + RANGE_LENGTH);
+                hi[common + RANGE_LENGTH] = AFTER_LETTERS;
+                hi[common + RANGE_LENGTH + 1] = '\0';
+                forEachRBTreeInRange(tree, strings[i], hi, countItem, &walked);
+            }
+            else if (phase == 3)
+            {
+                deleteFromRBTree(tree, strings[i]);
+            }
+        }
+        times[phase] = now() - start;
+        calls[phase] = compareCalls;
+    }
+    printf("%s (%lu found, %lu walked)\n", name, found, walked);
+    for (int phase = 0; phase < 4; ++phase)
+    {
+        printf("  %s: %lu compares, %.3f s\n", phases[phase], calls[phase], times[phase]);
+    }
+    freeRBTree(&tree);
+    free(hi);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    long unsigned amount = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_STRINGS;
+    int common = argc > 2 ? atoi(argv[2]) : 0;
+    char **strings = (char **) calloc(amount, sizeof(char *));
+    if (strings == NULL)
+    {
+        fprintf(stderr, "allocation failed\n");
+        return EXIT_FAILURE;
+    }
+    uint64_t state = amount;
+    int result = EXIT_SUCCESS;
+    for (long unsigned i = 0; i < amount && result == EXIT_SUCCESS; ++i)
+    {
+        strings[i] = (char *) malloc(common + RANDOM_LENGTH + 1);
+        if (strings[i] == NULL)
+        {
+            result = EXIT_FAILURE;
+            break;
+        }
+        memset(strings[i], 'a', common);
+        for (int j = 0; j < RANDOM_LENGTH; ++j)
+        {
+            strings[i][common + j] = (char) ('a' + nextRandom(&state) % LETTERS);
+        }
+        strings[i][common + RANDOM_LENGTH] = '\0';
+    }
+    RBTreeOptions plain = {.prefixFunc = NULL}, prefixed = {.prefixFunc = packedPrefix};
+    if (result == EXIT_FAILURE || !benchTree("CompareFunc only", strings, amount, common, &plain) ||
+        !benchTree("with PrefixFunc", strings, amount, common, &prefixed))
+    {
+        fprintf(stderr, "allocation failed\n");
+        result = EXIT_FAILURE;
+    }
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        free(strings[i]);
+    }
+    free(strings);
+    return result;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file templateBench.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Compares a tree of double items that compares through its CompareFunc with a doubleTree.
+ *
+ * @section DESCRIPTION
+ * Inserts random doubles (1M by default, or the amount given as the first argument) into both trees, looks each of
+ * them up LOOKUP_ROUNDS times and deletes them, and prints the time of every phase. Both trees hold the same
+ * allocated items, so the only difference is the comparison the descents call: through compFunc, or inlined by
+ * RBTREE_DEFINE. Build with:
+ * gcc -O2 -I. bench/templateBench.c DoubleRBTree.c RBTree.c -o templateBench
+ */
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 199309L
+
+#include "DoubleRBTree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+// -------------------------- const definitions -------------------------
+#define DEFAULT_ITEMS (1000000ul)
+
+#define LOOKUP_ROUNDS (3)
+
+#define SEED (0x9E3779B97F4A7C15ull)
+
+#define NANO (1e-9)
+
+#define RANDOM_BITS (53)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief CompareFunc for items of type double.
+ */
+int doubleCompare(const void *a, const void *b)
+{
+    double keyA = *(const double *) a;
+    double keyB = *(const double *) b;
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+/**
+ * @param state The state of the generator, advanced by the call.
+ * @return The next pseudo random number of a splitmix64 sequence.
+ */
+uint64_t nextRandom(uint64_t *state)
+{
+    uint64_t z = (*state += SEED);
+    z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31u);
+}
+
+/**
+ * @return The current time of a monotonic clock, in seconds.
+ */
+double now(void)
+{
+    struct timespec spec;
+    clock_gettime(CLOCK_MONOTONIC, &spec);
+    return (double) spec.tv_sec + (double) spec.tv_nsec * NANO;
+}
+
+/**
+ * @brief Inserts, finds and deletes the keys in a tree, and prints the time of every phase.
+ * @param name The name of the tree to print.
+ * @param inlined Whether to use the functions of doubleTree or the ones of RBTree.h.
+ * @return 1 on success, 0 if an allocation failed.
+ */
+int benchTree(const char *name, const double *keys, long unsigned amount, int inlined)
+{
+    RBTree *tree = inlined ? doubleTreeNew(free, NULL) : newRBTree(doubleCompare, free);
+    if (tree == NULL)
+    {
+        return 0;
+    }
+    double start = now();
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        double *item = (double *) malloc(sizeof(double));
+        if (item == NULL)
+        {
+            freeRBTree(&tree);
+            return 0;
+        }
+        *item = keys[i];
+        if (!(inlined ? doubleTreeInsert(tree, item) : insertToRBTree(tree, item)))
+        {
+            free(item);
+        }
+    }
+    double inserted = now();
+    long unsigned found = 0;
+    for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+    {
+        for (long unsigned i = 0; i < amount; ++i)
+        {
+            found += inlined ? doubleTreeContains(tree, keys + i) : RBTreeContains(tree, keys + i);
+        }
+    }
+    double looked = now();
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        if (inlined)
+        {
+            doubleTreeDelete(tree, keys + i);
+        }
+        else
+        {
+            deleteFromRBTree(tree, (void *) (keys + i));
+        }
+    }
+    double deleted = now();
+    printf("%s insert %.3f s, lookup %.3f s, delete %.3f s (%lu found)\n", name, inserted - start,
+           looked - inserted, deleted - looked, found);
+    freeRBTree(&tree);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    long unsigned amount = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_ITEMS;
+    double *keys = (double *) malloc(amount * sizeof(double));
+    if (keys == NULL)
+    {
+        fprintf(stderr, "allocation failed\n");
+        return EXIT_FAILURE;
+    }
+    uint64_t state = amount;
+    for (long unsigned i = 0; i < amount; ++i)
+    {
+        keys[i] = (double) (nextRandom(&state) >> (64 - RANDOM_BITS)) / (double) ((uint64_t) 1 << RANDOM_BITS);
+    }
+    if (!benchTree("compFunc:  ", keys, amount, 0) || !benchTree("doubleTree:", keys, amount, 1))
+    {
+        fprintf(stderr, "allocation failed\n");
+        free(keys);
+        return EXIT_FAILURE;
+    }
+    free(keys);
+    return EXIT_SUCCESS;
+}
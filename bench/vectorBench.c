@@ -0,0 +1,104 @@
+/**
+ * @file vectorBench.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 22 may 2020
+ *
+ * @brief Times every version of the vector loops the processor supports.
+ *
+ * @section DESCRIPTION
+ * Calls sumOfSquares and firstDifference on vectors of a few lengths (and of the length given as the first argument)
+ * with the scalar, AVX2 and AVX-512 versions of the loops in turn, and prints the time of a call of each. The compared
+ * vectors differ in their last coordinate, so firstDifference reads all of them. Build with:
+ * gcc -O2 -I. bench/vectorBench.c VectorKernels.c -o vectorBench
+ */
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 199309L
+
+#include "VectorKernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+// -------------------------- const definitions -------------------------
+#define CALLS (1000000)
+
+#define NANO (1e-9)
+
+#define MICRO (1e6)
+
+#define KERNELS_AMOUNT (3)
+
+#define LENGTHS_AMOUNT (4)
+// ------------------------------ functions -----------------------------
+/**
+ * @return The current time of a monotonic clock, in seconds.
+ */
+double now(void)
+{
+    struct timespec spec;
+    clock_gettime(CLOCK_MONOTONIC, &spec);
+    return (double) spec.tv_sec + (double) spec.tv_nsec * NANO;
+}
+
+/**
+ * @brief Times the loops on vectors of one length with the version in use, and prints the time of a call.
+ * @return 1 on success, 0 if an allocation failed.
+ */
+int benchLength(const char *name, int len)
+{
+    double *a = (double *) malloc(len * sizeof(double));
+    double *b = (double *) malloc(len * sizeof(double));
+    if (a == NULL || b == NULL)
+    {
+        free(a);
+        free(b);
+        return 0;
+    }
+    for (int i = 0; i < len; ++i)
+    {
+        a[i] = b[i] = i * 0.5;
+    }
+    b[len - 1] += 1;
+    volatile double sum = 0;
+    volatile int index = 0;
+    double start = now();
+    for (int i = 0; i < CALLS; ++i)
+    {
+        sum += sumOfSquares(a, len);
+    }
+    double summed = now();
+    for (int i = 0; i < CALLS; ++i)
+    {
+        index += firstDifference(a, b, len);
+    }
+    double compared = now();
+    printf("%-7s %5d coordinates: norm %.3f us, compare %.3f us\n", name, len, (summed - start) * MICRO / CALLS,
+           (compared - summed) * MICRO / CALLS);
+    free(a);
+    free(b);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    const VectorKernels kernels[KERNELS_AMOUNT] = {SCALAR_KERNELS, AVX2_KERNELS, AVX512_KERNELS};
+    const char *names[KERNELS_AMOUNT] = {"scalar", "AVX2", "AVX-512"};
+    int lengths[LENGTHS_AMOUNT] = {8, 64, 512, argc > 1 ? atoi(argv[1]) : 4096};
+    for (int k = 0; k < KERNELS_AMOUNT; ++k)
+    {
+        if (!useVectorKernels(kernels[k]))
+        {
+            printf("%-7s not supported\n", names[k]);
+            continue;
+        }
+        for (int l = 0; l < LENGTHS_AMOUNT; ++l)
+        {
+            if (lengths[l] > 0 && !benchLength(names[k], lengths[l]))
+            {
+                fprintf(stderr, "allocation failed\n");
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
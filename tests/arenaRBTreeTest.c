@@ -0,0 +1,224 @@
+/**
+ * @file arenaRBTreeTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests ArenaRBTree.
+ *
+ * @section DESCRIPTION
+ * Changes an ArenaRBTree by random insertions and deletions, checking after every round the red black rules, the
+ * links and the order of its nodes, and its items against a reference. Checks that the arena grows past its first
+ * capacity and that released nodes are reused before it grows again, and that a tree that does not free its items
+ * leaves them alone.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include "ArenaRBTree.h"
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define RANGE (3000)
+
+#define ROUNDS (40)
+
+#define CHANGES_PER_ROUND (200)
+
+// the nodes of a new arena, in ArenaRBTree.c.
+#define INITIAL_CAPACITY (16u)
+
+#define NIL (0u)
+
+#define NIL_HEIGHT (1)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief Checks the sub-tree of a node: the red black rules, the parent links and that its items are between the
+ * bounds, and counts them.
+ * @param tree The tree of the node.
+ * @param node The index of the node, NIL for an empty sub-tree.
+ * @param parent The index of the parent of node.
+ * @param lo All the items must be greater than it, NULL for no bound.
+ * @param hi All the items must be smaller than it, NULL for no bound.
+ * @param count Incremented by the amount of items of the sub-tree.
+ * @return The black height of the sub-tree.
+ */
+static int checkArenaNode(const ArenaRBTree *tree, uint32_t node, uint32_t parent, const int *lo, const int *hi,
+                          long unsigned *count)
+{
+    if (node == NIL)
+    {
+        return NIL_HEIGHT;
+    }
+    const ArenaNode *nodes = tree->nodes;
+    CHECK(node < tree->used);
+    CHECK(nodes[node].parent == parent);
+    CHECK(nodes[node].data != NULL);
+    const int *item = (const int *) nodes[node].data;
+    CHECK(lo == NULL || *lo < *item);
+    CHECK(hi == NULL || *item < *hi);
+    if (nodes[node].color == RED)
+    {
+        CHECK(nodes[nodes[node].left].color == BLACK && nodes[nodes[node].right].color == BLACK);
+    }
+    (*count)++;
+    int leftHeight = checkArenaNode(tree, nodes[node].left, node, lo, item, count);
+    int rightHeight = checkArenaNode(tree, nodes[node].right, node, item, hi, count);
+    CHECK(leftHeight == rightHeight);
+    return leftHeight + (nodes[node].color == BLACK);
+}
+
+/**
+ * @brief Checks all the invariants of an arena tree and compares its items with a reference.
+ * @param tree A tree of ints.
+ * @param present present[k] is not 0 if k is in the tree.
+ */
+static void checkArenaTree(const ArenaRBTree *tree, const char *present)
+{
+    long unsigned count = 0, expected = 0;
+    CHECK(tree->nodes[NIL].color == BLACK && tree->nodes[NIL].data == NULL);
+    CHECK(tree->root == NIL || tree->nodes[tree->root].color == BLACK);
+    CHECK(tree->used <= tree->capacity);
+    checkArenaNode(tree, tree->root, NIL, NULL, NULL, &count);
+    CHECK(count == tree->size);
+    for (int k = 0; k < RANGE; ++k)
+    {
+        CHECK(ArenaRBTreeContains(tree, &k) == (present[k] != 0));
+        expected += present[k] != 0;
+    }
+    CHECK(count == expected);
+}
+
+/**
+ * @param tree A tree.
+ * @param data An item of the tree.
+ * @return The index of the node that holds data.
+ */
+static uint32_t nodeOf(const ArenaRBTree *tree, const void *data)
+{
+    uint32_t cur = tree->root;
+    while (cur != NIL && tree->compFunc(data, tree->nodes[cur].data) != 0)
+    {
+        cur = tree->compFunc(data, tree->nodes[cur].data) < 0 ? tree->nodes[cur].left : tree->nodes[cur].right;
+    }
+    CHECK(cur != NIL);
+    return cur;
+}
+
+/**
+ * @brief Inserts and deletes random keys, and checks the tree after every round.
+ * @param state The state of the random draws.
+ */
+static void checkChurn(uint64_t *state)
+{
+    ArenaRBTree *tree = newArenaRBTree(intCompare, free);
+    char present[RANGE] = {0};
+    CHECK(tree != NULL);
+    CHECK(tree->capacity == INITIAL_CAPACITY);
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        int insertChance = round < ROUNDS / 2 ? 3 : 1;
+        for (int change = 0; change < CHANGES_PER_ROUND; ++change)
+        {
+            int key = randomBelow(state, RANGE);
+            if (randomBelow(state, 4) < insertChance)
+            {
+                int *item = newInt(key);
+                CHECK(insertToArenaRBTree(tree, item) == !present[key]);
+                if (present[key])
+                {
+                    free(item);
+                }
+                present[key] = 1;
+            }
+            else
+            {
+                CHECK(deleteFromArenaRBTree(tree, &key) == (present[key] != 0));
+                present[key] = 0;
+            }
+        }
+        checkArenaTree(tree, present);
+    }
+    CHECK(tree->capacity > INITIAL_CAPACITY);
+    freeArenaRBTree(&tree);
+    CHECK(tree == NULL);
+}
+
+/**
+ * @brief Checks that the arena grows past its first capacity, and that deleted nodes are taken again before it grows
+ * any further.
+ */
+static void checkReuse(void)
+{
+    ArenaRBTree *tree = newArenaRBTree(intCompare, free);
+    char present[RANGE] = {0};
+    CHECK(tree != NULL);
+    int amount = 4 * INITIAL_CAPACITY;
+    for (int key = 0; key < amount; ++key)
+    {
+        CHECK(insertToArenaRBTree(tree, newInt(key)));
+        present[key] = 1;
+    }
+    checkArenaTree(tree, present);
+    CHECK(tree->capacity >= (uint32_t) amount + 1);
+    uint32_t used = tree->used, capacity = tree->capacity;
+
+    // the free list hands out the last released node first.
+    int first = 3, second = amount / 2;
+    uint32_t firstNode = nodeOf(tree, &first), secondNode = nodeOf(tree, &second);
+    CHECK(deleteFromArenaRBTree(tree, &first));
+    CHECK(deleteFromArenaRBTree(tree, &second));
+    present[first] = present[second] = 0;
+    checkArenaTree(tree, present);
+    CHECK(insertToArenaRBTree(tree, newInt(amount)));
+    CHECK(nodeOf(tree, &amount) == secondNode);
+    int next = amount + 1;
+    CHECK(insertToArenaRBTree(tree, newInt(next)));
+    CHECK(nodeOf(tree, &next) == firstNode);
+    present[amount] = present[next] = 1;
+    CHECK(tree->used == used && tree->capacity == capacity);
+    checkArenaTree(tree, present);
+
+    // with the free list empty the arena is taken from again.
+    int last = amount + 2;
+    CHECK(insertToArenaRBTree(tree, newInt(last)));
+    present[last] = 1;
+    CHECK(nodeOf(tree, &last) == used && tree->used == used + 1);
+    checkArenaTree(tree, present);
+    freeArenaRBTree(&tree);
+}
+
+/**
+ * @brief Checks a tree without a free function: deleting and freeing it leave the items alone.
+ */
+static void checkNoFreeFunc(void)
+{
+    int items[RANGE];
+    char present[RANGE] = {0};
+    ArenaRBTree *tree = newArenaRBTree(intCompare, NULL);
+    CHECK(tree != NULL);
+    for (int key = 0; key < RANGE; ++key)
+    {
+        items[key] = key;
+        CHECK(insertToArenaRBTree(tree, &items[key]));
+        present[key] = 1;
+    }
+    for (int key = 0; key < RANGE; key += 3)
+    {
+        CHECK(deleteFromArenaRBTree(tree, &key));
+        present[key] = 0;
+    }
+    checkArenaTree(tree, present);
+    freeArenaRBTree(&tree);
+    for (int key = 0; key < RANGE; ++key)
+    {
+        CHECK(items[key] == key);
+    }
+}
+
+int main(void)
+{
+    uint64_t state = 1;
+    checkChurn(&state);
+    checkReuse();
+    checkNoFreeFunc();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,255 @@
+/**
+ * @file augmentationTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests the augmentations of a tree: RBTreeSummary and RBTreeRangeSummary.
+ *
+ * @section DESCRIPTION
+ * Keeps two augmentations in a tree of ints: the sum of the cached squares of the items, and a hash of the items in
+ * order, whose merge is not commutative so a summary merged out of order is caught. Changes the tree by insertions,
+ * deletions, batches, splits, joins and set operations, and after every round checks the red black rules, the
+ * sub-tree sizes, and the summaries of the tree and of random ranges against a walk over the reference.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define RANGE (3000)
+
+#define ROUNDS (60)
+
+#define CHANGES_PER_ROUND (80)
+
+#define RANGES_PER_ROUND (40)
+
+#define BATCH (40)
+
+#define HASH_BASE (1000003ull)
+
+#define SQUARES (0)
+
+#define ORDER_HASH (1)
+
+#define AUGMENTATIONS (2)
+// ------------------------------ structs -------------------------------
+/**
+ * a polynomial hash of a sequence of items, and the power of the base it shifts a following hash by.
+ */
+typedef struct OrderHash
+{
+    uint64_t hash;
+    uint64_t power;
+} OrderHash;
+// ------------------------------ functions -----------------------------
+/**
+ * @brief CacheFunc that keeps the square of an int item.
+ */
+void cacheSquare(const void *object, void *cache)
+{
+    long long key = *(const int *) object;
+    *(long long *) cache = key * key;
+}
+
+/**
+ * @brief SummarizeFunc of the sum of the squares, read from the cache.
+ */
+void summarizeSquare(void *summary, const void *object, const void *cache)
+{
+    (void) object;
+    CHECK(cache != NULL);
+    *(long long *) summary = *(const long long *) cache;
+}
+
+/**
+ * @brief MergeFunc of the sum of the squares.
+ */
+void mergeSquares(void *result, const void *first, const void *second)
+{
+    *(long long *) result = *(const long long *) first + *(const long long *) second;
+}
+
+/**
+ * @brief SummarizeFunc of the hash of the items in order.
+ */
+void summarizeOrder(void *summary, const void *object, const void *cache)
+{
+    (void) cache;
+    OrderHash *order = (OrderHash *) summary;
+    order->hash = (uint64_t) *(const int *) object + 1;
+    order->power = HASH_BASE;
+}
+
+/**
+ * @brief MergeFunc of the hash of the items in order.
+ */
+void mergeOrder(void *result, const void *first, const void *second)
+{
+    const OrderHash *left = (const OrderHash *) first;
+    const OrderHash *right = (const OrderHash *) second;
+    OrderHash merged = {left->hash * right->power + right->hash, left->power * right->power};
+    *(OrderHash *) result = merged;
+}
+
+/**
+ * @brief Computes both summaries of the reference items from lo to hi, by a walk.
+ * @return The amount of items in the range.
+ */
+int walkSummaries(const char *present, int lo, int hi, long long *squares, OrderHash *order)
+{
+    int amount = 0;
+    *squares = 0;
+    order->hash = 0;
+    order->power = 1;
+    for (int k = lo < 0 ? 0 : lo; k <= hi && k < RANGE; ++k)
+    {
+        if (present[k])
+        {
+            OrderHash item = {(uint64_t) k + 1, HASH_BASE};
+            *squares += (long long) k * k;
+            mergeOrder(order, order, &item);
+            amount++;
+        }
+    }
+    return amount;
+}
+
+/**
+ * @brief Compares the summaries of a tree and of random ranges with walks over the reference.
+ */
+void checkSummaries(const RBTree *tree, const char *present, uint64_t *state)
+{
+    checkIntItems(tree, present, RANGE);
+    long long squares;
+    OrderHash order;
+    if (walkSummaries(present, 0, RANGE, &squares, &order) == 0)
+    {
+        CHECK(RBTreeSummary(tree, SQUARES) == NULL && RBTreeSummary(tree, ORDER_HASH) == NULL);
+    }
+    else
+    {
+        CHECK(*(const long long *) RBTreeSummary(tree, SQUARES) == squares);
+        const OrderHash *summary = (const OrderHash *) RBTreeSummary(tree, ORDER_HASH);
+        CHECK(summary->hash == order.hash && summary->power == order.power);
+    }
+    CHECK(RBTreeSummary(tree, AUGMENTATIONS) == NULL && RBTreeSummary(tree, -1) == NULL);
+    for (int i = 0; i < RANGES_PER_ROUND; ++i)
+    {
+        int lo = randomBelow(state, RANGE + 2) - 1;
+        int hi = lo + randomBelow(state, RANGE / 4);
+        long long rangeSquares = -1;
+        OrderHash rangeOrder = {0, 0};
+        int exists = walkSummaries(present, lo, hi, &squares, &order) > 0;
+        CHECK(RBTreeRangeSummary(tree, SQUARES, &lo, &hi, &rangeSquares) == exists);
+        CHECK(RBTreeRangeSummary(tree, ORDER_HASH, &lo, &hi, &rangeOrder) == exists);
+        CHECK(!exists || (rangeSquares == squares && rangeOrder.hash == order.hash && rangeOrder.power == order.power));
+        CHECK(!RBTreeRangeSummary(tree, AUGMENTATIONS, &lo, &hi, &rangeSquares));
+    }
+}
+
+/**
+ * @brief Inserts a key into a tree unless it is there, and marks it.
+ */
+void insertKey(RBTree *tree, char *present, int key)
+{
+    int *item = newInt(key);
+    if (!insertToRBTree(tree, item))
+    {
+        free(item);
+    }
+    present[key] = 1;
+}
+
+/**
+ * @brief Makes a tree like another one, with random keys of a part of the range, and marks them.
+ */
+RBTree *newRandomTree(const RBTree *like, char *present, int lo, int hi, uint64_t *state)
+{
+    RBTree *tree = newRBTreeLike(like);
+    CHECK(tree != NULL);
+    for (int i = 0; i < BATCH; ++i)
+    {
+        insertKey(tree, present, lo + randomBelow(state, hi - lo));
+    }
+    return tree;
+}
+
+/**
+ * @brief Changes the tree by one random round of every kind of change.
+ */
+void changeTree(RBTree *tree, char *present, int round, uint64_t *state)
+{
+    int insertChance = round < ROUNDS / 2 ? 3 : 1;
+    for (int i = 0; i < CHANGES_PER_ROUND; ++i)
+    {
+        int key = randomBelow(state, RANGE);
+        if (randomBelow(state, 4) < insertChance)
+        {
+            insertKey(tree, present, key);
+        }
+        else
+        {
+            deleteFromRBTree(tree, &key);
+            present[key] = 0;
+        }
+    }
+    void *batch[BATCH];
+    for (int i = 0; i < BATCH; ++i)
+    {
+        batch[i] = newInt(randomBelow(state, RANGE));
+    }
+    long unsigned oldSize = tree->size;
+    CHECK(insertManyToRBTree(tree, batch, BATCH));
+    for (int i = 0; i < BATCH; ++i)
+    {
+        present[*(int *) batch[i]] = 1;
+        if ((long unsigned) i >= tree->size - oldSize)
+        {
+            free(batch[i]);
+        }
+    }
+
+    int key = randomBelow(state, RANGE);
+    RBTree *greater = splitRBTree(tree, &key);
+    CHECK(greater != NULL);
+    int *pivot = (int *) RBTreeSelect(greater, 0);
+    if (pivot != NULL)
+    {
+        int pivotKey = *pivot;
+        CHECK(deleteFromRBTree(greater, &pivotKey));
+        pivot = newInt(pivotKey);
+    }
+    CHECK(joinRBTree(tree, pivot, &greater));
+
+    char inOther[RANGE] = {0};
+    RBTree *other = newRandomTree(tree, present, 0, RANGE, state);
+    CHECK(unionRBTree(tree, &other));
+    other = newRandomTree(tree, inOther, RANGE / 4, RANGE / 2, state);
+    CHECK(subtractRBTree(tree, &other));
+    for (int k = 0; k < RANGE; ++k)
+    {
+        present[k] = (char) (present[k] && !inOther[k]);
+    }
+}
+
+int main(void)
+{
+    const RBTreeAugmentation augmentations[AUGMENTATIONS] = {{sizeof(long long), summarizeSquare, mergeSquares, 0},
+                                                             {sizeof(OrderHash), summarizeOrder, mergeOrder, 0}};
+    RBTreeOptions options = {.orderStatistics = 1, .poolSlabNodes = 64, .cacheSize = sizeof(long long),
+                             .cacheFunc = cacheSquare, .augmentations = augmentations,
+                             .augmentationsAmount = AUGMENTATIONS};
+    RBTree *tree = newRBTreeWithOptions(intCompare, free, &options);
+    char present[RANGE] = {0};
+    CHECK(tree != NULL);
+    uint64_t state = 1;
+    checkSummaries(tree, present, &state);
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        changeTree(tree, present, round, &state);
+        checkSummaries(tree, present, &state);
+    }
+    freeRBTree(&tree);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file boundsTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests RBTreeLowerBound, RBTreeUpperBound, RBTreeFloor and RBTreeCeiling.
+ *
+ * @section DESCRIPTION
+ * Searches trees of random keys for every key of their range and one past each end: keys below the smallest item,
+ * above the greatest, exactly on items and between them. Compares the found items and the iterators with a
+ * reference, on a plain tree, a tree with a prefix and an empty tree.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define RANGE (2000)
+
+// the items are kept away from the ends of the range, so some keys are below and above all of them.
+#define MARGIN (50)
+
+#define DENSITY (3)
+
+#define NONE (-1)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief PrefixFunc for items of type int, in the order of the ints.
+ */
+uint64_t intPrefix(const void *object)
+{
+    return (uint64_t) ((int64_t) *(const int *) object - INT32_MIN);
+}
+
+/**
+ * @brief Checks what a search found: the item and the iterator on it, or NULL and the end.
+ * @param tree The searched tree.
+ * @param found The found item.
+ * @param iter The iterator the search placed.
+ * @param expected The key of the item that should be found, NONE if there is none.
+ */
+void checkFound(const RBTree *tree, const int *found, const RBTreeIterator *iter, int expected)
+{
+    CHECK(iter->tree == tree);
+    if (expected == NONE)
+    {
+        CHECK(found == NULL && iter->node == NULL);
+        return;
+    }
+    CHECK(found != NULL && *found == expected);
+    CHECK(iter->node != NULL && iter->node->data == found);
+}
+
+/**
+ * @brief Searches a tree with every key of the range and one past each end, and compares the results with a
+ * reference.
+ * @param tree A tree of ints.
+ * @param present present[k] is not 0 if k is in the tree.
+ */
+void checkBounds(const RBTree *tree, const char *present)
+{
+    for (int key = -1; key <= RANGE; ++key)
+    {
+        int floor = NONE, above = NONE;
+        for (int k = key < RANGE ? key : RANGE - 1; k >= 0 && floor == NONE; --k)
+        {
+            floor = present[k] ? k : NONE;
+        }
+        for (int k = key + 1; k < RANGE && above == NONE; ++k)
+        {
+            above = present[k] ? k : NONE;
+        }
+        int onItem = key >= 0 && key < RANGE && present[key];
+        int ceiling = onItem ? key : above;
+        RBTreeIterator iter;
+        checkFound(tree, (const int *) RBTreeLowerBound(tree, &key, &iter), &iter, ceiling);
+        checkFound(tree, (const int *) RBTreeCeiling(tree, &key, &iter), &iter, ceiling);
+        checkFound(tree, (const int *) RBTreeUpperBound(tree, &key, &iter), &iter, above);
+        checkFound(tree, (const int *) RBTreeFloor(tree, &key, &iter), &iter, floor);
+        // without an iterator the same items are found.
+        CHECK(RBTreeLowerBound(tree, &key, NULL) == RBTreeLowerBound(tree, &key, &iter));
+        CHECK(RBTreeUpperBound(tree, &key, NULL) == RBTreeUpperBound(tree, &key, &iter));
+        CHECK(RBTreeFloor(tree, &key, NULL) == RBTreeFloor(tree, &key, &iter));
+    }
+}
+
+/**
+ * @brief Fills a tree with random keys away from the ends of the range, and checks its bounds.
+ * @param options The features of the tree.
+ * @param state The state of the random draws.
+ */
+void checkTree(const RBTreeOptions *options, uint64_t *state)
+{
+    RBTree *tree = newRBTreeWithOptions(intCompare, free, options);
+    char present[RANGE] = {0};
+    CHECK(tree != NULL);
+    checkBounds(tree, present);
+    for (int key = MARGIN; key < RANGE - MARGIN; ++key)
+    {
+        if (randomBelow(state, DENSITY) == 0)
+        {
+            CHECK(insertToRBTree(tree, newInt(key)));
+            present[key] = 1;
+        }
+    }
+    checkRBTree(tree);
+    checkBounds(tree, present);
+    freeRBTree(&tree);
+}
+
+int main(void)
+{
+    uint64_t state = 1;
+    RBTreeOptions prefixed = {.prefixFunc = intPrefix};
+    checkTree(NULL, &state);
+    checkTree(&prefixed, &state);
+    return EXIT_SUCCESS;
+}
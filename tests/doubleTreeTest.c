@@ -0,0 +1,227 @@
+/**
+ * @file doubleTreeTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests the trees of doubles made by RBTreeTemplate.h.
+ *
+ * @section DESCRIPTION
+ * Changes a doubleTree (items that point to doubles) and a tree of double keys kept in the nodes at random, over
+ * values of every magnitude and sign, the infinities among them. After every round checks the red black rules, walks
+ * both trees in order against a sorted reference, and compares the lookups and the bounds of keys below, above,
+ * between and on the items with it. Checks that -0.0 equals 0.0, and that the keys tree never holds -0.0, whose bits
+ * are those of a NULL item. NaN has no place in the order of the doubles, so it is not used.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include "DoubleRBTree.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define VALUES (1000)
+
+#define ROUNDS (30)
+
+#define CHANGES_PER_ROUND (100)
+
+#define MANTISSA_RANGE (1 << 30)
+
+#define EXPONENT_RANGE (60)
+// ------------------------------ functions -----------------------------
+RBTREE_DECLARE_KEYS(doubleKeys, double);
+
+RBTREE_DEFINE_KEYS(doubleKeys, double, RBTREE_COMPARE_NUMBERS)
+
+/**
+ * @brief Compares two doubles, for qsort.
+ */
+int compareValues(const void *a, const void *b)
+{
+    return RBTREE_COMPARE_NUMBERS(*(const double *) a, *(const double *) b);
+}
+
+/**
+ * @return A new allocated double. The test fails if the allocation fails.
+ */
+double *newDouble(double value)
+{
+    double *item = (double *) malloc(sizeof(double));
+    CHECK(item != NULL);
+    *item = value;
+    return item;
+}
+
+/**
+ * @brief Makes VALUES different doubles in ascending order: the extremes, the values around 0 and random values of
+ * many magnitudes.
+ */
+void makeValues(double *values, uint64_t *state)
+{
+    const double special[] = {0.0, -INFINITY, INFINITY, DBL_MAX, -DBL_MAX, DBL_MIN, -DBL_MIN, DBL_TRUE_MIN, 1.0, -1.0};
+    const int amount = sizeof(special) / sizeof(special[0]);
+    int made = 0;
+    while (made < VALUES)
+    {
+        double value = made < amount ? special[made] :
+                       ldexp((double) (randomBelow(state, MANTISSA_RANGE) - MANTISSA_RANGE / 2),
+                             randomBelow(state, EXPONENT_RANGE) - EXPONENT_RANGE / 2);
+        int repeated = 0;
+        for (int i = 0; i < made && !repeated; ++i)
+        {
+            repeated = values[i] == value;
+        }
+        if (!repeated)
+        {
+            values[made++] = value;
+        }
+    }
+    qsort(values, VALUES, sizeof(double), compareValues);
+}
+
+/**
+ * @return The index of the first present value not smaller than key (greater than key if strict), VALUES if none.
+ */
+int referenceAbove(const double *values, const char *present, double key, int strict)
+{
+    for (int i = 0; i < VALUES; ++i)
+    {
+        if (present[i] && (strict ? values[i] > key : values[i] >= key))
+        {
+            return i;
+        }
+    }
+    return VALUES;
+}
+
+/**
+ * @brief Compares the bounds of a key in both trees with the reference.
+ */
+void checkBounds(const RBTree *items, const RBTree *keys, const double *values, const char *present, double key)
+{
+    int lower = referenceAbove(values, present, key, 0);
+    int upper = referenceAbove(values, present, key, 1);
+    RBTreeIterator iter;
+    const double *found = doubleTreeLowerBound(items, &key, &iter);
+    CHECK(lower == VALUES ? found == NULL : (found != NULL && *found == values[lower] && iter.node->data == found));
+    found = (const double *) RBTreeUpperBound(items, &key, NULL);
+    CHECK(upper == VALUES ? found == NULL : (found != NULL && *found == values[upper]));
+    double foundKey = NAN;
+    CHECK(doubleKeysLowerBound(keys, key, NULL, &foundKey) == (lower < VALUES));
+    CHECK(lower == VALUES || foundKey == values[lower]);
+    void *floor = RBTreeFloor(keys, doubleKeysItem(key), NULL);
+    int last = VALUES;
+    for (int i = 0; i < VALUES && values[i] <= key; ++i)
+    {
+        last = present[i] ? i : last;
+    }
+    CHECK(last == VALUES ? floor == NULL : (floor != NULL && doubleKeysKey(floor) == values[last]));
+}
+
+/**
+ * @brief Compares both trees with the reference: their items in order, the lookups and the bounds.
+ */
+void checkTrees(const RBTree *items, const RBTree *keys, const double *values, const char *present, uint64_t *state)
+{
+    checkRBTree(items);
+    checkRBTree(keys);
+    RBTreeIterator itemIter, keyIter;
+    const double *item = (const double *) RBTreeFirst(items, &itemIter);
+    RBTreeFirst(keys, &keyIter);
+    for (int i = 0; i < VALUES; ++i)
+    {
+        CHECK(doubleTreeContains(items, &values[i]) == present[i]);
+        CHECK(doubleKeysContains(keys, values[i]) == present[i]);
+        if (present[i])
+        {
+            double key;
+            CHECK(item != NULL && *item == values[i]);
+            CHECK(doubleKeysIteratorKey(&keyIter, &key) && key == values[i]);
+            item = (const double *) RBTreeNext(&itemIter);
+            RBTreeNext(&keyIter);
+        }
+        checkBounds(items, keys, values, present, values[i]);
+        if (i + 1 < VALUES && isfinite(values[i]) && isfinite(values[i + 1]))
+        {
+            checkBounds(items, keys, values, present, values[i] / 2 + values[i + 1] / 2);
+        }
+    }
+    CHECK(item == NULL && !doubleKeysIteratorKey(&keyIter, NULL));
+    checkBounds(items, keys, values, present, -INFINITY);
+    checkBounds(items, keys, values, present, INFINITY);
+    checkBounds(items, keys, values, present, values[randomBelow(state, VALUES)]);
+}
+
+/**
+ * @brief Checks that -0.0 equals 0.0 in both trees, and that the keys tree rejects -0.0.
+ */
+void checkZeros(void)
+{
+    RBTree *items = doubleTreeNew(free, NULL);
+    RBTree *keys = doubleKeysNew(NULL);
+    CHECK(items != NULL && keys != NULL);
+    double negativeZero = -0.0;
+    double *zero = newDouble(0.0);
+    CHECK(doubleTreeInsert(items, zero));
+    double *other = newDouble(negativeZero);
+    CHECK(!doubleTreeInsert(items, other));
+    free(other);
+    CHECK(doubleTreeFind(items, &negativeZero) == zero);
+    CHECK(doubleTreeDelete(items, &negativeZero) && items->size == 0);
+
+    CHECK(doubleKeysItem(negativeZero) == NULL);
+    CHECK(!doubleKeysInsert(keys, negativeZero) && keys->size == 0);
+    CHECK(doubleKeysInsert(keys, 0.0) && !doubleKeysInsert(keys, negativeZero));
+    CHECK(doubleKeysContains(keys, negativeZero));
+    double found = NAN;
+    CHECK(doubleKeysLowerBound(keys, negativeZero, NULL, &found) && found == 0.0 && !signbit(found));
+    CHECK(doubleKeysDelete(keys, negativeZero) && keys->size == 0);
+    checkRBTree(items);
+    checkRBTree(keys);
+    freeRBTree(&items);
+    freeRBTree(&keys);
+}
+
+int main(void)
+{
+    uint64_t state = 1;
+    double values[VALUES];
+    char present[VALUES] = {0};
+    makeValues(values, &state);
+    RBTreeOptions options = {.orderStatistics = 1, .poolSlabNodes = 64};
+    RBTree *items = doubleTreeNew(free, &options);
+    RBTree *keys = doubleKeysNew(NULL);
+    CHECK(items != NULL && keys != NULL);
+    checkTrees(items, keys, values, present, &state);
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        int insertChance = round < ROUNDS / 2 ? 3 : 1;
+        for (int i = 0; i < CHANGES_PER_ROUND; ++i)
+        {
+            int k = randomBelow(&state, VALUES);
+            if (randomBelow(&state, 4) < insertChance)
+            {
+                double *item = newDouble(values[k]);
+                CHECK(doubleTreeInsert(items, item) == !present[k]);
+                if (present[k])
+                {
+                    free(item);
+                }
+                CHECK(doubleKeysInsert(keys, values[k]) == !present[k]);
+                present[k] = 1;
+            }
+            else
+            {
+                CHECK(doubleTreeDelete(items, &values[k]) == present[k]);
+                CHECK(doubleKeysDelete(keys, values[k]) == present[k]);
+                present[k] = 0;
+            }
+        }
+        checkTrees(items, keys, values, present, &state);
+    }
+    freeRBTree(&items);
+    freeRBTree(&keys);
+    checkZeros();
+    return EXIT_SUCCESS;
+}
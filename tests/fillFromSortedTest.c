@@ -0,0 +1,124 @@
+/**
+ * @file fillFromSortedTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests fillRBTreeFromSorted.
+ *
+ * @section DESCRIPTION
+ * Fills trees of every amount up to MAX_SMALL_AMOUNT and one large tree, with and without order statistics, checks the
+ * red black rules and the items of every tree and keeps them valid through random insertions and deletions. Checks
+ * that unsorted, repeated or NULL items and a tree that is not empty are rejected, leaving the tree empty.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include <stdlib.h>
+#include <string.h>
+// -------------------------- const definitions -------------------------
+#define MAX_SMALL_AMOUNT (300)
+
+#define LARGE_AMOUNT (50000)
+
+#define CHANGES (200)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief Fills a tree with the numbers from 0 to amount - 1, checks it, and changes it at random while checking it.
+ * @param amount The amount of items to fill the tree with.
+ * @param options The options of the tree.
+ * @param changes The amount of random insertions and deletions after the fill.
+ */
+void checkFill(int amount, const RBTreeOptions *options, int changes)
+{
+    RBTree *tree = newRBTreeWithOptions(intCompare, free, options);
+    CHECK(tree != NULL);
+    void **items = (void **) malloc((amount + 1) * sizeof(void *));
+    int range = 2 * amount + 1;
+    char *present = (char *) calloc(range, 1);
+    CHECK(items != NULL && present != NULL);
+    for (int i = 0; i < amount; ++i)
+    {
+        items[i] = newInt(2 * i);
+        present[2 * i] = 1;
+    }
+    CHECK(fillRBTreeFromSorted(tree, items, amount));
+    checkIntItems(tree, present, range);
+    uint64_t state = (uint64_t) amount;
+    for (int i = 0; i < changes; ++i)
+    {
+        int key = randomBelow(&state, range);
+        if (present[key])
+        {
+            CHECK(deleteFromRBTree(tree, &key));
+            present[key] = 0;
+        }
+        else
+        {
+            CHECK(insertToRBTree(tree, newInt(key)));
+            present[key] = 1;
+        }
+        checkRBTree(tree);
+    }
+    checkIntItems(tree, present, range);
+    freeRBTree(&tree);
+    free(items);
+    free(present);
+}
+
+/**
+ * @brief Checks that a fill of the given items fails and leaves the tree empty, and frees the items.
+ * @param tree An empty tree.
+ * @param items The items to fill the tree with.
+ * @param amount The amount of items.
+ */
+void checkRejected(RBTree *tree, void **items, int amount)
+{
+    CHECK(!fillRBTreeFromSorted(tree, items, amount));
+    CHECK(tree->size == 0 && tree->root == NULL);
+    checkRBTree(tree);
+    for (int i = 0; i < amount; ++i)
+    {
+        free(items[i]);
+    }
+}
+
+/**
+ * @brief Checks that bad input is rejected.
+ */
+void checkBadInput(void)
+{
+    RBTreeOptions options = {.orderStatistics = 1};
+    RBTree *tree = newRBTreeWithOptions(intCompare, free, &options);
+    CHECK(tree != NULL);
+    void *unsorted[] = {newInt(1), newInt(3), newInt(2), newInt(4)};
+    checkRejected(tree, unsorted, 4);
+    void *repeated[] = {newInt(1), newInt(2), newInt(2), newInt(4)};
+    checkRejected(tree, repeated, 4);
+    void *withNull[] = {newInt(1), NULL, newInt(4)};
+    checkRejected(tree, withNull, 3);
+    CHECK(!fillRBTreeFromSorted(NULL, NULL, 0));
+
+    CHECK(insertToRBTree(tree, newInt(0)));
+    void *sorted[] = {newInt(1), newInt(2)};
+    CHECK(!fillRBTreeFromSorted(tree, sorted, 2));
+    CHECK(tree->size == 1);
+    checkRBTree(tree);
+    free(sorted[0]);
+    free(sorted[1]);
+    freeRBTree(&tree);
+}
+
+int main(void)
+{
+    RBTreeOptions plain = {0};
+    RBTreeOptions counted = {.orderStatistics = 1, .poolSlabNodes = 64};
+    for (int amount = 0; amount <= MAX_SMALL_AMOUNT; ++amount)
+    {
+        checkFill(amount, &plain, amount);
+        checkFill(amount, &counted, amount);
+    }
+    checkFill(LARGE_AMOUNT, &plain, CHANGES);
+    checkFill(LARGE_AMOUNT, &counted, CHANGES);
+    checkBadInput();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file insertManyTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests insertManyToRBTree.
+ *
+ * @section DESCRIPTION
+ * Inserts random batches, with items repeated in the batch and items already in the tree, into trees with and without
+ * order statistics. Checks the red black rules and the items of the tree after every batch, that the inserted items
+ * come first in the batch in ascending order, and that a batch with a NULL item leaves the tree unchanged.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define RANGE (5000)
+
+#define BATCHES (200)
+
+#define MAX_BATCH (300)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief Inserts random batches into a tree and checks the tree and the reordered batches.
+ * @param options The options of the tree.
+ */
+void checkBatches(const RBTreeOptions *options)
+{
+    RBTree *tree = newRBTreeWithOptions(intCompare, free, options);
+    char *present = (char *) calloc(RANGE, 1);
+    void **items = (void **) malloc(MAX_BATCH * sizeof(void *));
+    CHECK(tree != NULL && present != NULL && items != NULL);
+    uint64_t state = 1;
+    for (int batch = 0; batch < BATCHES; ++batch)
+    {
+        int amount = randomBelow(&state, MAX_BATCH + 1);
+        for (int i = 0; i < amount; ++i)
+        {
+            items[i] = newInt(randomBelow(&state, RANGE));
+        }
+        long unsigned oldSize = tree->size;
+        CHECK(insertManyToRBTree(tree, items, amount));
+        long unsigned inserted = tree->size - oldSize;
+        for (long unsigned i = 0; i < inserted; ++i)
+        {
+            int key = *(int *) items[i];
+            CHECK(!present[key]);
+            CHECK(i == 0 || *(int *) items[i - 1] < key);
+            present[key] = 1;
+        }
+        for (long unsigned i = inserted; i < (long unsigned) amount; ++i)
+        {
+            CHECK(present[*(int *) items[i]]);
+            free(items[i]);
+        }
+        checkIntItems(tree, present, RANGE);
+    }
+    freeRBTree(&tree);
+    free(present);
+    free(items);
+}
+
+/**
+ * @brief Checks that a batch with a NULL item fails and leaves the tree unchanged.
+ */
+void checkNullItem(void)
+{
+    RBTree *tree = newRBTree(intCompare, free);
+    char present[RANGE] = {0};
+    CHECK(tree != NULL);
+    for (int key = 0; key < RANGE; key += 3)
+    {
+        CHECK(insertToRBTree(tree, newInt(key)));
+        present[key] = 1;
+    }
+    void *items[] = {newInt(1), newInt(2), NULL, newInt(4)};
+    CHECK(!insertManyToRBTree(tree, items, 4));
+    checkIntItems(tree, present, RANGE);
+    for (int i = 0; i < 4; ++i)
+    {
+        free(items[i]);
+    }
+    CHECK(insertManyToRBTree(tree, NULL, 0));
+    checkIntItems(tree, present, RANGE);
+    freeRBTree(&tree);
+}
+
+int main(void)
+{
+    RBTreeOptions plain = {0};
+    RBTreeOptions counted = {.orderStatistics = 1, .poolSlabNodes = 64};
+    checkBatches(&plain);
+    checkBatches(&counted);
+    checkNullItem();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file int64TreeTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests the int64Tree that keeps its keys in the nodes.
+ *
+ * @section DESCRIPTION
+ * Changes int64Trees at random over keys of the whole int64_t range, the extremes among them, with and without order
+ * statistics. After every round checks the red black rules and the sub-tree sizes, walks the keys in order against a
+ * sorted reference, and compares the lookups, the lower bounds and the ranks with it. Checks that INT64_MIN is never
+ * held, and that the keys work with the functions of RBTree.h through int64TreeItem and int64TreeKey.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include "Int64RBTree.h"
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define KEYS (1500)
+
+#define ROUNDS (40)
+
+#define CHANGES_PER_ROUND (100)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief Compares two int64_t, for qsort.
+ */
+int compareKeys(const void *a, const void *b)
+{
+    return RBTREE_COMPARE_NUMBERS(*(const int64_t *) a, *(const int64_t *) b);
+}
+
+/**
+ * @brief Makes KEYS different keys in ascending order: the extremes, the keys around 0 and random keys of the whole
+ * range.
+ */
+void makeKeys(int64_t *keys, uint64_t *state)
+{
+    const int64_t special[] = {INT64_MIN + 1, INT64_MAX, INT64_MAX - 1, -1, 0, 1, INT64_MIN / 2, INT64_MAX / 2};
+    const int amount = sizeof(special) / sizeof(special[0]);
+    int made = 0;
+    while (made < KEYS)
+    {
+        int64_t key = made < amount ? special[made] :
+                      (int64_t) (((uint64_t) randomBelow(state, 1 << 30) << 34u) ^
+                                 (uint64_t) randomBelow(state, 1 << 30));
+        int repeated = key == INT64_MIN;
+        for (int i = 0; i < made && !repeated; ++i)
+        {
+            repeated = keys[i] == key;
+        }
+        if (!repeated)
+        {
+            keys[made++] = key;
+        }
+    }
+    qsort(keys, KEYS, sizeof(int64_t), compareKeys);
+}
+
+/**
+ * @brief Compares the keys, the lookups, the lower bounds and the ranks of a tree with the reference.
+ */
+void checkKeys(const RBTree *tree, const int64_t *keys, const char *present)
+{
+    checkRBTree(tree);
+    RBTreeIterator iter;
+    int64_t key;
+    RBTreeFirst(tree, &iter);
+    long unsigned smaller = 0;
+    int next = KEYS;
+    for (int i = KEYS - 1; i >= 0; --i)
+    {
+        next = present[i] ? i : next;
+    }
+    for (int i = 0; i < KEYS; ++i)
+    {
+        CHECK(int64TreeContains(tree, keys[i]) == present[i]);
+        CHECK(RBTreeRank(tree, int64TreeItem(keys[i])) == smaller);
+        int64_t found;
+        RBTreeIterator bound;
+        CHECK(int64TreeLowerBound(tree, keys[i], &bound, &found) == (next < KEYS));
+        CHECK(next == KEYS || (found == keys[next] && int64TreeIteratorKey(&bound, &key) && key == found));
+        if (present[i])
+        {
+            CHECK(int64TreeIteratorKey(&iter, &key) && key == keys[i]);
+            CHECK(int64TreeKey(RBTreeSelect(tree, smaller)) == keys[i]);
+            RBTreeNext(&iter);
+            smaller++;
+            next = i + 1;
+            while (next < KEYS && !present[next])
+            {
+                next++;
+            }
+        }
+    }
+    CHECK(!int64TreeIteratorKey(&iter, &key));
+    CHECK(smaller == tree->size);
+    CHECK(!int64TreeContains(tree, INT64_MIN));
+}
+
+/**
+ * @brief Changes an int64Tree at random and compares it with the reference after every round.
+ * @param options The options of the tree.
+ */
+void checkTree(const int64_t *keys, const RBTreeOptions *options, uint64_t *state)
+{
+    RBTree *tree = int64TreeNew(options);
+    char present[KEYS] = {0};
+    CHECK(tree != NULL);
+    checkKeys(tree, keys, present);
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        int insertChance = round < ROUNDS / 2 ? 3 : 1;
+        for (int i = 0; i < CHANGES_PER_ROUND; ++i)
+        {
+            int k = randomBelow(state, KEYS);
+            if (randomBelow(state, 4) < insertChance)
+            {
+                // half of the insertions go through RBTree.h.
+                CHECK((i % 2 ? int64TreeInsert(tree, keys[k]) : insertToRBTree(tree, int64TreeItem(keys[k]))) ==
+                      !present[k]);
+                present[k] = 1;
+            }
+            else
+            {
+                CHECK(int64TreeDelete(tree, keys[k]) == present[k]);
+                present[k] = 0;
+            }
+        }
+        CHECK(!int64TreeInsert(tree, INT64_MIN));
+        checkKeys(tree, keys, present);
+    }
+    freeRBTree(&tree);
+}
+
+int main(void)
+{
+    CHECK(int64TreeItem(INT64_MIN) == NULL && int64TreeItem(0) != NULL);
+    CHECK(int64TreeKey(int64TreeItem(INT64_MAX)) == INT64_MAX && int64TreeKey(int64TreeItem(-1)) == -1);
+    uint64_t state = 1;
+    int64_t *keys = (int64_t *) malloc(KEYS * sizeof(int64_t));
+    CHECK(keys != NULL);
+    makeKeys(keys, &state);
+    RBTreeOptions plain = {0};
+    RBTreeOptions counted = {.orderStatistics = 1, .poolSlabNodes = 64};
+    checkTree(keys, &plain, &state);
+    checkTree(keys, &counted, &state);
+    free(keys);
+    return EXIT_SUCCESS;
+}
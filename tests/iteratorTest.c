@@ -0,0 +1,95 @@
+/**
+ * @file iteratorTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests RBTreeFirst, RBTreeLast, RBTreeNext and RBTreePrev.
+ *
+ * @section DESCRIPTION
+ * Changes a tree at random and, after every batch of changes, checks its red black rules and walks it forwards and
+ * backwards, comparing the items with a reference. Checks that the end position moves to the first and to the last
+ * item, that a walk can turn around in the middle, and that an empty tree has no items.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define RANGE (3000)
+
+#define ROUNDS (60)
+
+#define CHANGES_PER_ROUND (100)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief Walks a tree forwards and backwards and compares the items with a reference.
+ * @param tree A tree of ints.
+ * @param present present[k] is not 0 if k is in the tree.
+ */
+void checkWalks(const RBTree *tree, const char *present)
+{
+    checkIntItems(tree, present, RANGE);
+    RBTreeIterator iter;
+    const int *item = (const int *) RBTreeLast(tree, &iter);
+    for (int k = RANGE - 1; k >= 0; --k)
+    {
+        if (present[k])
+        {
+            CHECK(item != NULL && *item == k);
+            const int *next = (const int *) RBTreeNext(&iter);
+            RBTreeIterator back = iter;
+            CHECK(*(const int *) RBTreePrev(&back) == k);
+            CHECK(next == NULL || *next > k);
+            item = (const int *) RBTreePrev(&iter);
+            CHECK(*item == k);
+            item = (const int *) RBTreePrev(&iter);
+        }
+    }
+    CHECK(item == NULL && iter.node == NULL);
+    const int *last = (const int *) RBTreePrev(&iter);
+    RBTreeIterator end;
+    const int *first = (const int *) RBTreeFirst(tree, &end);
+    CHECK(RBTreePrev(&end) == NULL);
+    CHECK(RBTreeNext(&end) == first);
+    RBTreeLast(tree, &end);
+    CHECK(RBTreeNext(&end) == NULL);
+    CHECK(RBTreePrev(&end) == last);
+}
+
+int main(void)
+{
+    RBTree *tree = newRBTree(intCompare, free);
+    char present[RANGE] = {0};
+    CHECK(tree != NULL);
+    RBTreeIterator iter;
+    CHECK(RBTreeFirst(tree, &iter) == NULL && RBTreeNext(&iter) == NULL);
+    CHECK(RBTreeLast(tree, &iter) == NULL && RBTreePrev(&iter) == NULL);
+    uint64_t state = 1;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        // the first half of the rounds mostly insert, the second half mostly delete.
+        int insertChance = round < ROUNDS / 2 ? 3 : 1;
+        for (int i = 0; i < CHANGES_PER_ROUND; ++i)
+        {
+            int key = randomBelow(&state, RANGE);
+            if (randomBelow(&state, 4) < insertChance)
+            {
+                int *item = newInt(key);
+                CHECK(insertToRBTree(tree, item) == !present[key]);
+                if (present[key])
+                {
+                    free(item);
+                }
+                present[key] = 1;
+            }
+            else
+            {
+                CHECK(deleteFromRBTree(tree, &key) == present[key]);
+                present[key] = 0;
+            }
+        }
+        checkWalks(tree, present);
+    }
+    freeRBTree(&tree);
+    return EXIT_SUCCESS;
+}
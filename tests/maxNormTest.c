@@ -0,0 +1,164 @@
+/**
+ * @file maxNormTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests the max norm augmentation and the searches for the vector with the largest norm.
+ *
+ * @section DESCRIPTION
+ * Changes vector trees at random: a plain one, one that caches the norms, and ones set by setMaxNormOptions, with and
+ * without order statistics. After every round checks the red black rules and the sub-tree sizes, and compares the
+ * largest norm of the whole tree (searched on the calling thread and on a pool) and of random ranges with a walk over
+ * all the vectors. The coordinates are small integers, so the norms are exact whatever order they are summed in.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include "RBTreeParallel.h"
+#include "Structs.h"
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define MAX_LEN (5)
+
+#define COORDINATES (21)
+
+#define ROUNDS (40)
+
+#define CHANGES_PER_ROUND (120)
+
+#define RANGES_PER_ROUND (30)
+
+#define WORKERS (4)
+
+#define NO_NORM (-1.0)
+// ------------------------------ functions -----------------------------
+/**
+ * @return A new allocated vector of random length and coordinates. The test fails if the allocation fails.
+ */
+Vector *newRandomVector(uint64_t *state)
+{
+    Vector *vec = (Vector *) malloc(sizeof(Vector));
+    CHECK(vec != NULL);
+    vec->len = 1 + randomBelow(state, MAX_LEN);
+    vec->vector = (double *) malloc(vec->len * sizeof(double));
+    CHECK(vec->vector != NULL);
+    for (int i = 0; i < vec->len; ++i)
+    {
+        vec->vector[i] = (double) (randomBelow(state, COORDINATES) - COORDINATES / 2);
+    }
+    return vec;
+}
+
+/**
+ * @return The norm of a vector as findMaxNormVectorInTree measures it (the sum of the squares), exact for integer
+ * coordinates. NO_NORM for a vector with no coordinates.
+ */
+double normOf(const Vector *vec)
+{
+    if (vec->vector == NULL)
+    {
+        return NO_NORM;
+    }
+    double norm = 0;
+    for (int i = 0; i < vec->len; ++i)
+    {
+        norm += vec->vector[i] * vec->vector[i];
+    }
+    return norm;
+}
+
+/**
+ * @return The largest norm of the vectors of a tree between lo and hi, walking over all of them. NO_NORM if there are
+ * none. lo and hi may be NULL to not bound the range.
+ */
+double walkMaxNorm(const RBTree *tree, const Vector *lo, const Vector *hi)
+{
+    double maxNorm = NO_NORM;
+    RBTreeIterator iter;
+    for (const Vector *vec = (const Vector *) RBTreeFirst(tree, &iter); vec != NULL;
+         vec = (const Vector *) RBTreeNext(&iter))
+    {
+        if ((lo == NULL || vectorCompare1By1(lo, vec) <= 0) && (hi == NULL || vectorCompare1By1(vec, hi) <= 0) &&
+            normOf(vec) > maxNorm)
+        {
+            maxNorm = normOf(vec);
+        }
+    }
+    return maxNorm;
+}
+
+/**
+ * @brief Checks that a found vector has the expected norm, and frees it.
+ */
+void checkFound(Vector *found, double expected)
+{
+    CHECK(found != NULL);
+    CHECK(normOf(found) == expected);
+    freeVector(found);
+}
+
+/**
+ * @brief Changes a vector tree at random and checks its searches for the largest norm.
+ * @param options The options of the tree.
+ * @param pool The pool to search on.
+ */
+void checkTree(const RBTreeOptions *options, ForkJoinPool *pool)
+{
+    RBTree *tree = newRBTreeWithOptions(vectorCompare1By1, freeVector, options);
+    CHECK(tree != NULL);
+    checkFound(findMaxNormVectorInTree(tree), NO_NORM);
+    uint64_t state = 1;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        int insertChance = round < ROUNDS / 2 ? 3 : 1;
+        for (int i = 0; i < CHANGES_PER_ROUND; ++i)
+        {
+            Vector *vec = newRandomVector(&state);
+            if (randomBelow(&state, 4) < insertChance)
+            {
+                if (!insertToRBTree(tree, vec))
+                {
+                    freeVector(vec);
+                }
+                continue;
+            }
+            void *near = RBTreeLowerBound(tree, vec, NULL);
+            if (near != NULL)
+            {
+                CHECK(deleteFromRBTree(tree, near));
+            }
+            freeVector(vec);
+        }
+        checkRBTree(tree);
+        double expected = walkMaxNorm(tree, NULL, NULL);
+        checkFound(findMaxNormVectorInTree(tree), expected);
+        checkFound(findMaxNormVectorInTreeParallel(tree, pool), expected);
+        for (int i = 0; i < RANGES_PER_ROUND; ++i)
+        {
+            Vector *lo = newRandomVector(&state);
+            Vector *hi = newRandomVector(&state);
+            checkFound(findMaxNormVectorInRange(tree, lo, hi), walkMaxNorm(tree, lo, hi));
+            freeVector(lo);
+            freeVector(hi);
+        }
+    }
+    freeRBTree(&tree);
+}
+
+int main(void)
+{
+    ForkJoinPool *pool = newForkJoinPool(WORKERS);
+    CHECK(pool != NULL);
+    RBTreeOptions plain = {0};
+    RBTreeOptions cached = {.cacheSize = sizeof(double), .cacheFunc = cacheNorm};
+    RBTreeOptions augmented = {0};
+    setMaxNormOptions(&augmented);
+    RBTreeOptions counted = {.orderStatistics = 1, .poolSlabNodes = 32, .prefixFunc = vectorPrefix};
+    setMaxNormOptions(&counted);
+    checkTree(&plain, pool);
+    checkTree(&cached, pool);
+    checkTree(&augmented, pool);
+    checkTree(&counted, pool);
+    freeForkJoinPool(&pool);
+    return EXIT_SUCCESS;
+}
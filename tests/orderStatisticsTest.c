@@ -0,0 +1,115 @@
+/**
+ * @file orderStatisticsTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests RBTreeRank and RBTreeSelect.
+ *
+ * @section DESCRIPTION
+ * Changes two trees in the same random way, one keeping order statistics and one without them, by insertions,
+ * batches and deletions. After every round checks the red black rules and the sub-tree sizes, and compares the rank of
+ * every key and the item at every index of both trees with a reference.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define RANGE (2000)
+
+#define ROUNDS (40)
+
+#define CHANGES_PER_ROUND (150)
+
+#define BATCH (50)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief Compares the ranks and the selected items of a tree with a reference.
+ * @param tree A tree of ints.
+ * @param present present[k] is not 0 if k is in the tree.
+ */
+void checkOrder(const RBTree *tree, const char *present)
+{
+    checkIntItems(tree, present, RANGE);
+    long unsigned smaller = 0;
+    for (int k = 0; k <= RANGE; ++k)
+    {
+        CHECK(RBTreeRank(tree, &k) == smaller);
+        if (k < RANGE && present[k])
+        {
+            const int *item = (const int *) RBTreeSelect(tree, smaller);
+            CHECK(item != NULL && *item == k);
+            smaller++;
+        }
+    }
+    CHECK(smaller == tree->size);
+    CHECK(RBTreeSelect(tree, tree->size) == NULL);
+    CHECK(RBTreeSelect(tree, (long unsigned) -1) == NULL);
+}
+
+/**
+ * @brief Inserts a key into a tree unless it is there.
+ */
+void insertKey(RBTree *tree, int key)
+{
+    int *item = newInt(key);
+    if (!insertToRBTree(tree, item))
+    {
+        free(item);
+    }
+}
+
+int main(void)
+{
+    RBTreeOptions counted = {.orderStatistics = 1, .poolSlabNodes = 32};
+    RBTree *trees[] = {newRBTreeWithOptions(intCompare, free, &counted), newRBTree(intCompare, free)};
+    char present[RANGE] = {0};
+    CHECK(trees[0] != NULL && trees[1] != NULL && trees[0]->countOffset != 0 && trees[1]->countOffset == 0);
+    checkOrder(trees[0], present);
+    uint64_t state = 1;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        int insertChance = round < ROUNDS / 2 ? 3 : 1;
+        for (int i = 0; i < CHANGES_PER_ROUND; ++i)
+        {
+            int key = randomBelow(&state, RANGE);
+            int insert = randomBelow(&state, 4) < insertChance;
+            for (int t = 0; t < 2; ++t)
+            {
+                if (insert)
+                {
+                    insertKey(trees[t], key);
+                }
+                else
+                {
+                    deleteFromRBTree(trees[t], &key);
+                }
+            }
+            present[key] = (char) insert;
+        }
+        void *batch[BATCH];
+        int first = randomBelow(&state, RANGE - BATCH);
+        for (int i = 0; i < BATCH; ++i)
+        {
+            batch[i] = newInt(first + BATCH - 1 - i);
+        }
+        CHECK(insertManyToRBTree(trees[0], batch, BATCH));
+        for (int i = 0; i < BATCH; ++i)
+        {
+            if (present[*(int *) batch[i]])
+            {
+                free(batch[i]);
+            }
+            else
+            {
+                insertKey(trees[1], *(int *) batch[i]);
+                present[*(int *) batch[i]] = 1;
+            }
+        }
+        checkOrder(trees[0], present);
+        checkOrder(trees[1], present);
+    }
+    freeRBTree(&trees[0]);
+    freeRBTree(&trees[1]);
+    return EXIT_SUCCESS;
+}
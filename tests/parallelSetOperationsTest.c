@@ -0,0 +1,146 @@
+/**
+ * @file parallelSetOperationsTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests unionRBTreeParallel, intersectRBTreeParallel and subtractRBTreeParallel.
+ *
+ * @section DESCRIPTION
+ * Builds pairs of trees tall enough for the halves of the set operations to be combined on the workers of a pool,
+ * runs every parallel operation on a copy of each pair and the sequential operation on another copy, and checks that
+ * the results have the same items, the items of a reference, and all the invariants of a tree. The compare function
+ * records whether a worker called it, so the test fails if the work never left the calling thread.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include "RBTreeParallel.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define RANGE (300000)
+
+#define WORKERS (4)
+
+// the black height from which the halves of an operation are combined in parallel, in RBTreeParallel.c.
+#define PARALLEL_HEIGHT (8)
+
+#define OPERATIONS (3)
+// ------------------------------ structs -------------------------------
+/**
+ * a set operation in its sequential and parallel forms, with the reference of what it keeps.
+ */
+typedef struct SetOperation
+{
+    int (*sequential)(RBTree *tree, RBTree **other);
+    int (*parallel)(RBTree *tree, RBTree **other, ForkJoinPool *pool);
+    int keepsOnlyTree; // whether the result keeps an item of tree that is not in other.
+    int keepsBoth; // whether the result keeps an item of both trees.
+    int keepsOnlyOther; // whether the result keeps an item of other that is not in tree.
+} SetOperation;
+// ------------------------------ functions -----------------------------
+static pthread_t mainThread;
+
+static atomic_int workerCompared;
+
+/**
+ * @brief CompareFunc for items of type int, that records whether a thread other than the main one called it.
+ */
+int recordingCompare(const void *a, const void *b)
+{
+    if (!pthread_equal(pthread_self(), mainThread))
+    {
+        atomic_store(&workerCompared, 1);
+    }
+    return intCompare(a, b);
+}
+
+/**
+ * @brief Fills two trees with the same random keys of the range, each kept with a chance of one in density.
+ */
+void fillPair(RBTree *first, RBTree *second, char *present, int density, uint64_t *state)
+{
+    for (int key = 0; key < RANGE; ++key)
+    {
+        present[key] = (char) (randomBelow(state, density) == 0);
+        if (present[key])
+        {
+            CHECK(insertToRBTree(first, newInt(key)) && insertToRBTree(second, newInt(key)));
+        }
+    }
+}
+
+/**
+ * @brief Checks that two trees of ints have the same items.
+ */
+void checkSameItems(const RBTree *tree, const RBTree *other)
+{
+    RBTreeIterator iter, otherIter;
+    const int *item = (const int *) RBTreeFirst(tree, &iter);
+    const int *otherItem = (const int *) RBTreeFirst(other, &otherIter);
+    while (item != NULL && otherItem != NULL && *item == *otherItem)
+    {
+        item = (const int *) RBTreeNext(&iter);
+        otherItem = (const int *) RBTreeNext(&otherIter);
+    }
+    CHECK(item == NULL && otherItem == NULL);
+}
+
+/**
+ * @brief Runs an operation sequentially and on a pool over the same tall trees, and compares the results.
+ */
+void checkOperation(const SetOperation *operation, const RBTree *base, ForkJoinPool *pool, int treeDensity,
+                    int otherDensity, uint64_t *state)
+{
+    char *inTree = (char *) malloc(RANGE);
+    char *inOther = (char *) malloc(RANGE);
+    CHECK(inTree != NULL && inOther != NULL);
+    RBTree *sequential = newRBTreeLike(base), *sequentialOther = newRBTreeLike(base);
+    RBTree *parallel = newRBTreeLike(base), *parallelOther = newRBTreeLike(base);
+    CHECK(sequential != NULL && sequentialOther != NULL && parallel != NULL && parallelOther != NULL);
+    fillPair(sequential, parallel, inTree, treeDensity, state);
+    fillPair(sequentialOther, parallelOther, inOther, otherDensity, state);
+    CHECK(checkRBTree(parallel) >= PARALLEL_HEIGHT + 2 && checkRBTree(parallelOther) >= PARALLEL_HEIGHT + 2);
+
+    CHECK(operation->sequential(sequential, &sequentialOther));
+    atomic_store(&workerCompared, 0);
+    CHECK(operation->parallel(parallel, &parallelOther, pool));
+    CHECK(atomic_load(&workerCompared));
+    CHECK(sequentialOther == NULL && parallelOther == NULL);
+    for (int k = 0; k < RANGE; ++k)
+    {
+        inTree[k] = (char) (inTree[k] ? (inOther[k] ? operation->keepsBoth : operation->keepsOnlyTree) :
+                            (inOther[k] && operation->keepsOnlyOther));
+    }
+    checkIntItems(parallel, inTree, RANGE);
+    checkSameItems(parallel, sequential);
+    freeRBTree(&sequential);
+    freeRBTree(&parallel);
+    free(inTree);
+    free(inOther);
+}
+
+int main(void)
+{
+    const SetOperation operations[OPERATIONS] = {{unionRBTree, unionRBTreeParallel, 1, 1, 1},
+                                                 {intersectRBTree, intersectRBTreeParallel, 0, 1, 0},
+                                                 {subtractRBTree, subtractRBTreeParallel, 1, 0, 0}};
+    mainThread = pthread_self();
+    ForkJoinPool *pool = newForkJoinPool(WORKERS);
+    RBTreeOptions plain = {0};
+    RBTreeOptions counted = {.orderStatistics = 1, .poolSlabNodes = 256};
+    RBTree *bases[] = {newRBTreeWithOptions(recordingCompare, free, &plain),
+                       newRBTreeWithOptions(recordingCompare, free, &counted)};
+    CHECK(pool != NULL && bases[0] != NULL && bases[1] != NULL);
+    uint64_t state = 1;
+    for (int i = 0; i < OPERATIONS; ++i)
+    {
+        checkOperation(&operations[i], bases[0], pool, 2, 2, &state);
+        checkOperation(&operations[i], bases[1], pool, 2, 8, &state);
+    }
+    freeRBTree(&bases[0]);
+    freeRBTree(&bases[1]);
+    freeForkJoinPool(&pool);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file parallelWalkTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests forEachRBTreeParallel and reduceRBTreeParallel.
+ *
+ * @section DESCRIPTION
+ * Walks random trees of many sizes on a pool and on the calling thread. Checks that every item is visited exactly
+ * once, that a failed activation fails the walk, that the ranges of a reduction are contiguous and merged in order for
+ * any amount of parts, and that the walks leave the red black rules and the items of the tree as they were.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include "RBTreeParallel.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define RANGE (20000)
+
+#define WORKERS (4)
+
+#define MAX_PARTS (17)
+
+#define FAILING_KEY (-1)
+// ------------------------------ structs -------------------------------
+/**
+ * the result of a range of a reduction: its items must come in ascending order.
+ */
+typedef struct Span
+{
+    int first;
+    int last;
+    long unsigned amount;
+    int ordered;
+} Span;
+// ------------------------------ functions -----------------------------
+/**
+ * @brief forEachFunc that counts the visits of an int item in an array of atomic counters.
+ * @return 0 for the FAILING_KEY, 1 otherwise.
+ */
+int countVisit(const void *object, void *args)
+{
+    int key = *(const int *) object;
+    if (key == FAILING_KEY)
+    {
+        return 0;
+    }
+    atomic_fetch_add((atomic_int *) args + key, 1);
+    return 1;
+}
+
+/**
+ * @brief forEachFunc that adds an int item to the Span of its range.
+ */
+int extendSpan(const void *object, void *args)
+{
+    Span *span = (Span *) args;
+    int key = *(const int *) object;
+    if (span->amount == 0)
+    {
+        span->first = key;
+    }
+    else if (key <= span->last)
+    {
+        span->ordered = 0;
+    }
+    span->last = key;
+    span->amount++;
+    return 1;
+}
+
+/**
+ * @brief ReduceFunc that merges the Span of a range into the Span of the ranges before it.
+ */
+int mergeSpans(void *result, void *part)
+{
+    Span *left = (Span *) result;
+    const Span *right = (const Span *) part;
+    if (right->amount == 0)
+    {
+        return 1;
+    }
+    if (left->amount == 0)
+    {
+        *left = *right;
+        return 1;
+    }
+    left->ordered = left->ordered && right->ordered && left->last < right->first;
+    left->last = right->last;
+    left->amount += right->amount;
+    return 1;
+}
+
+/**
+ * @brief Walks a tree on a pool and checks the visits and the reductions.
+ * @param tree A tree of ints.
+ * @param present present[k] is not 0 if k is in the tree.
+ * @param pool The pool to walk on, may be NULL.
+ */
+void checkWalks(const RBTree *tree, const char *present, ForkJoinPool *pool)
+{
+    static atomic_int visits[RANGE];
+    for (int k = 0; k < RANGE; ++k)
+    {
+        atomic_store(&visits[k], 0);
+    }
+    CHECK(forEachRBTreeParallel(tree, pool, countVisit, visits));
+    int first = -1, last = -1;
+    for (int k = 0; k < RANGE; ++k)
+    {
+        CHECK(atomic_load(&visits[k]) == present[k]);
+        if (present[k])
+        {
+            first = first < 0 ? k : first;
+            last = k;
+        }
+    }
+    for (int parts = 1; parts <= MAX_PARTS; ++parts)
+    {
+        Span spans[MAX_PARTS] = {{0}};
+        void *partials[MAX_PARTS];
+        for (int i = 0; i < parts; ++i)
+        {
+            spans[i].ordered = 1;
+            partials[i] = &spans[i];
+        }
+        CHECK(reduceRBTreeParallel(tree, pool, extendSpan, partials, parts, mergeSpans));
+        CHECK(spans[0].ordered && spans[0].amount == tree->size);
+        CHECK(tree->size == 0 || (spans[0].first == first && spans[0].last == last));
+    }
+    checkIntItems(tree, present, RANGE);
+}
+
+int main(void)
+{
+    ForkJoinPool *pool = newForkJoinPool(WORKERS);
+    RBTree *tree = newRBTree(intCompare, free);
+    char *present = (char *) calloc(RANGE, 1);
+    CHECK(pool != NULL && tree != NULL && present != NULL);
+    uint64_t state = 1;
+    for (int size = 0; size < RANGE; size = 2 * size + 1)
+    {
+        while (tree->size < (long unsigned) size)
+        {
+            int key = randomBelow(&state, RANGE);
+            if (!present[key])
+            {
+                CHECK(insertToRBTree(tree, newInt(key)));
+                present[key] = 1;
+            }
+        }
+        checkWalks(tree, present, pool);
+        checkWalks(tree, present, NULL);
+    }
+    CHECK(insertToRBTree(tree, newInt(FAILING_KEY)));
+    static atomic_int visits[RANGE];
+    CHECK(!forEachRBTreeParallel(tree, pool, countVisit, visits));
+    CHECK(!forEachRBTreeParallel(tree, NULL, countVisit, visits));
+    freeRBTree(&tree);
+    freeForkJoinPool(&pool);
+    free(present);
+    return EXIT_SUCCESS;
+}
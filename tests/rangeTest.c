@@ -0,0 +1,126 @@
+/**
+ * @file rangeTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests forEachRBTreeInRange.
+ *
+ * @section DESCRIPTION
+ * Walks random ranges of a tree of random keys and compares the visited items with a reference: ranges below the
+ * smallest item and above the greatest, ranges whose ends are exactly on items, ranges of one key, empty ranges (with
+ * lo greater than hi, or between two items) and ranges whose callback stops the walk early.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define RANGE (2000)
+
+// the items are kept away from the ends of the range, so some ranges are below and above all of them.
+#define MARGIN (50)
+
+#define DENSITY (3)
+
+#define RANGES (3000)
+
+#define NO_LIMIT (-1)
+// ------------------------------ structs -------------------------------
+/**
+ * what a walk visited.
+ */
+typedef struct Visits
+{
+    int items[RANGE];
+    int amount;
+    int limit; // the amount of items after which the callback stops the walk, NO_LIMIT to never stop it.
+} Visits;
+// ------------------------------ functions -----------------------------
+/**
+ * @brief forEachFunc that records an item, and stops the walk once the limit is reached.
+ */
+int visit(const void *object, void *args)
+{
+    Visits *visits = (Visits *) args;
+    CHECK(visits->amount < RANGE);
+    visits->items[(visits->amount)++] = *(const int *) object;
+    return visits->limit == NO_LIMIT || visits->amount < visits->limit;
+}
+
+/**
+ * @brief Walks a range of a tree and compares the visited items with a reference.
+ * @param tree A tree of ints.
+ * @param present present[k] is not 0 if k is in the tree.
+ * @param lo The smallest key of the range.
+ * @param hi The greatest key of the range.
+ * @param limit The amount of items after which the callback stops the walk, NO_LIMIT to never stop it.
+ */
+void checkRange(const RBTree *tree, const char *present, int lo, int hi, int limit)
+{
+    Visits visits = {.amount = 0, .limit = limit};
+    int result = forEachRBTreeInRange(tree, &lo, &hi, visit, &visits);
+    int expected = 0;
+    for (int k = lo > 0 ? lo : 0; k <= hi && k < RANGE && (limit == NO_LIMIT || expected < limit); ++k)
+    {
+        if (present[k])
+        {
+            CHECK(expected < visits.amount && visits.items[expected] == k);
+            expected++;
+        }
+    }
+    CHECK(visits.amount == expected);
+    // the walk fails only if the callback stopped it.
+    CHECK(result == (limit == NO_LIMIT || expected < limit));
+}
+
+int main(void)
+{
+    uint64_t state = 1;
+    RBTree *tree = newRBTree(intCompare, free);
+    char present[RANGE] = {0};
+    CHECK(tree != NULL);
+    checkRange(tree, present, 0, RANGE, NO_LIMIT);
+    int first = RANGE, last = -1;
+    for (int key = MARGIN; key < RANGE - MARGIN; ++key)
+    {
+        if (randomBelow(&state, DENSITY) == 0)
+        {
+            CHECK(insertToRBTree(tree, newInt(key)));
+            present[key] = 1;
+            first = first < key ? first : key;
+            last = key;
+        }
+    }
+    CHECK(first < last);
+
+    // the whole tree, and the ranges just outside it.
+    checkRange(tree, present, -1, RANGE, NO_LIMIT);
+    checkRange(tree, present, first, last, NO_LIMIT);
+    checkRange(tree, present, 0, first - 1, NO_LIMIT);
+    checkRange(tree, present, last + 1, RANGE, NO_LIMIT);
+    checkRange(tree, present, 0, first, NO_LIMIT);
+    checkRange(tree, present, last, RANGE, NO_LIMIT);
+    // one key, on an item and between two items, and empty ranges.
+    int gap = first;
+    while (present[gap])
+    {
+        gap++;
+    }
+    checkRange(tree, present, first, first, NO_LIMIT);
+    checkRange(tree, present, gap, gap, NO_LIMIT);
+    checkRange(tree, present, last, first, NO_LIMIT);
+    checkRange(tree, present, RANGE / 2 + 1, RANGE / 2, NO_LIMIT);
+    // callbacks that stop the walk at once, in the middle and on the last item of the range.
+    checkRange(tree, present, first, last, 1);
+    checkRange(tree, present, first, last, (int) tree->size / 2);
+    checkRange(tree, present, first, last, (int) tree->size);
+    for (int i = 0; i < RANGES; ++i)
+    {
+        int lo = randomBelow(&state, RANGE + 2) - 1;
+        int hi = randomBelow(&state, RANGE + 2) - 1;
+        int limit = randomBelow(&state, 2) ? NO_LIMIT : 1 + randomBelow(&state, 20);
+        checkRange(tree, present, lo, hi, limit);
+    }
+    freeRBTree(&tree);
+    return EXIT_SUCCESS;
+}
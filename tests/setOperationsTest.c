@@ -0,0 +1,120 @@
+/**
+ * @file setOperationsTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests unionRBTree, intersectRBTree and subtractRBTree.
+ *
+ * @section DESCRIPTION
+ * Combines pairs of random trees of similar and of very different sizes, with and without order statistics, and
+ * checks the red black rules, the sub-tree sizes and the items of the result against a reference. Checks that trees
+ * which do not share nodes are not combined and are not changed.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define RANGE (6000)
+
+#define ROUNDS (30)
+// ------------------------------ structs -------------------------------
+/**
+ * one of the set operations, with the reference of what it keeps.
+ */
+typedef struct SetOperation
+{
+    int (*combine)(RBTree *tree, RBTree **other);
+    int keepsOnlyTree; // whether the result keeps an item of tree that is not in other.
+    int keepsBoth; // whether the result keeps an item of both trees.
+    int keepsOnlyOther; // whether the result keeps an item of other that is not in tree.
+} SetOperation;
+// ------------------------------ functions -----------------------------
+/**
+ * @brief Inserts every key of the range into a tree with a chance of one in density, and marks it.
+ */
+void fillRandomly(RBTree *tree, char *present, int density, uint64_t *state)
+{
+    for (int key = 0; key < RANGE; ++key)
+    {
+        if (randomBelow(state, density) == 0)
+        {
+            CHECK(insertToRBTree(tree, newInt(key)));
+            present[key] = 1;
+        }
+    }
+}
+
+/**
+ * @brief Combines random trees by an operation and compares the result with a reference.
+ * @param operation The operation to check.
+ * @param options The options of the trees.
+ * @param state The state of the random draws.
+ */
+void checkOperation(const SetOperation *operation, const RBTreeOptions *options, uint64_t *state)
+{
+    static const int densities[] = {1, 2, 3, 50, 1000};
+    const int amount = sizeof(densities) / sizeof(densities[0]);
+    RBTree *base = newRBTreeWithOptions(intCompare, free, options);
+    CHECK(base != NULL);
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        char inTree[RANGE] = {0};
+        char inOther[RANGE] = {0};
+        char expected[RANGE];
+        RBTree *tree = newRBTreeLike(base);
+        RBTree *other = newRBTreeLike(base);
+        CHECK(tree != NULL && other != NULL);
+        fillRandomly(tree, inTree, densities[round % amount], state);
+        fillRandomly(other, inOther, densities[(round / amount) % amount], state);
+        for (int k = 0; k < RANGE; ++k)
+        {
+            expected[k] = (char) (inTree[k] ? (inOther[k] ? operation->keepsBoth : operation->keepsOnlyTree) :
+                                  (inOther[k] && operation->keepsOnlyOther));
+        }
+        CHECK(operation->combine(tree, &other));
+        CHECK(other == NULL);
+        checkIntItems(tree, expected, RANGE);
+        freeRBTree(&tree);
+    }
+    freeRBTree(&base);
+}
+
+/**
+ * @brief Checks that trees which do not share nodes are not combined.
+ * @param operation The operation to check.
+ */
+void checkStrangers(const SetOperation *operation)
+{
+    RBTreeOptions pooled = {.poolSlabNodes = 16};
+    RBTree *tree = newRBTree(intCompare, free);
+    RBTree *other = newRBTreeWithOptions(intCompare, free, &pooled);
+    char inTree[RANGE] = {0};
+    char inOther[RANGE] = {0};
+    uint64_t state = 3;
+    CHECK(tree != NULL && other != NULL);
+    fillRandomly(tree, inTree, 2, &state);
+    fillRandomly(other, inOther, 2, &state);
+    CHECK(!operation->combine(tree, &other));
+    CHECK(other != NULL);
+    checkIntItems(tree, inTree, RANGE);
+    checkIntItems(other, inOther, RANGE);
+    freeRBTree(&tree);
+    freeRBTree(&other);
+}
+
+int main(void)
+{
+    const SetOperation operations[] = {{unionRBTree, 1, 1, 1}, {intersectRBTree, 0, 1, 0},
+                                       {subtractRBTree, 1, 0, 0}};
+    RBTreeOptions plain = {0};
+    RBTreeOptions counted = {.orderStatistics = 1, .poolSlabNodes = 64};
+    uint64_t state = 1;
+    for (int i = 0; i < 3; ++i)
+    {
+        checkOperation(&operations[i], &plain, &state);
+        checkOperation(&operations[i], &counted, &state);
+        checkStrangers(&operations[i]);
+    }
+    return EXIT_SUCCESS;
+}
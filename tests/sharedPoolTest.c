@@ -0,0 +1,155 @@
+/**
+ * @file sharedPoolTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests changing trees that share a node pool from different threads.
+ *
+ * @section DESCRIPTION
+ * Splits a pooled tree into shards and gives every shard to a thread of its own, that inserts and deletes items,
+ * splits the shard and joins it back, and builds and frees trees made like it, all while the other threads do the
+ * same with the shards that share its pool. Then checks every shard against a reference and joins them back. Also
+ * checks that a pool whose slabs would be too large for a size_t is rejected.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include <pthread.h>
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define RANGE (40000)
+
+#define SHARDS (4)
+
+#define ROUNDS (60)
+
+#define CHANGES_PER_ROUND (500)
+
+#define SCRATCH_ITEMS (200)
+// ------------------------------ structs -------------------------------
+/**
+ * a shard of the tree and the thread that changes it.
+ */
+typedef struct Shard
+{
+    pthread_t thread;
+    RBTree *tree;
+    char *present; // the reference of the whole range, with only the keys of the shard marked.
+    int lo, hi; // the keys of the shard.
+    uint64_t state;
+} Shard;
+// ------------------------------ functions -----------------------------
+/**
+ * @brief Inserts and deletes random keys of a shard, and splits it and joins it back, every round.
+ * @param arg The shard.
+ * @return NULL.
+ */
+static void *changeShard(void *arg)
+{
+    Shard *shard = (Shard *) arg;
+    int width = shard->hi - shard->lo;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        // insert more than delete in the first half, so the shard grows and then shrinks back.
+        int insertChance = round < ROUNDS / 2 ? 3 : 1;
+        for (int change = 0; change < CHANGES_PER_ROUND; ++change)
+        {
+            int key = shard->lo + randomBelow(&shard->state, width);
+            if (!shard->present[key] && randomBelow(&shard->state, 4) < insertChance)
+            {
+                CHECK(insertToRBTree(shard->tree, newInt(key)));
+                shard->present[key] = 1;
+            }
+            else if (shard->present[key] && randomBelow(&shard->state, 4) >= insertChance)
+            {
+                CHECK(deleteFromRBTree(shard->tree, &key));
+                shard->present[key] = 0;
+            }
+        }
+        int key = shard->lo + randomBelow(&shard->state, width);
+        RBTree *greater = splitRBTree(shard->tree, &key);
+        CHECK(greater != NULL);
+        CHECK(joinRBTree(shard->tree, NULL, &greater));
+
+        RBTree *scratch = newRBTreeLike(shard->tree);
+        CHECK(scratch != NULL);
+        for (int i = 0; i < SCRATCH_ITEMS; ++i)
+        {
+            CHECK(insertToRBTree(scratch, newInt(i)));
+        }
+        freeRBTree(&scratch);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Checks that trees are constructed only if a slab of their pool has a size that fits in a size_t.
+ */
+static void checkSlabSizes(void)
+{
+    RBTreeOptions options = {.poolSlabNodes = SIZE_MAX};
+    CHECK(newRBTreeWithOptions(intCompare, free, &options) == NULL);
+    // one node more than fits, where the multiplication would wrap around.
+    options.poolSlabNodes = SIZE_MAX / sizeof(Node) + 1;
+    CHECK(newRBTreeWithOptions(intCompare, free, &options) == NULL);
+    // the plain nodes fit, but not with the sizes of their sub-trees.
+    options.poolSlabNodes = SIZE_MAX / sizeof(Node) / 10 * 9;
+    options.orderStatistics = 1;
+    CHECK(newRBTreeWithOptions(intCompare, free, &options) == NULL);
+    // a size that fits is constructed, the slab is allocated only with the first node.
+    options.poolSlabNodes = SIZE_MAX / (2 * sizeof(Node));
+    RBTree *tree = newRBTreeWithOptions(intCompare, free, &options);
+    CHECK(tree != NULL);
+    freeRBTree(&tree);
+}
+
+int main(void)
+{
+    checkSlabSizes();
+    RBTreeOptions options = {.orderStatistics = 1, .poolSlabNodes = 32};
+    RBTree *tree = newRBTreeWithOptions(intCompare, free, &options);
+    char *present = (char *) calloc(SHARDS * RANGE, sizeof(char));
+    Shard shards[SHARDS];
+    CHECK(tree != NULL && present != NULL);
+    uint64_t state = 1;
+    for (int key = 0; key < RANGE; ++key)
+    {
+        if (randomBelow(&state, 2))
+        {
+            CHECK(insertToRBTree(tree, newInt(key)));
+        }
+    }
+    // the shards are split off from the greatest down, the smallest one stays in tree.
+    for (int i = SHARDS - 1; i >= 0; --i)
+    {
+        shards[i] = (Shard) {.present = present + i * RANGE, .lo = i * RANGE / SHARDS,
+                             .hi = (i + 1) * RANGE / SHARDS, .state = (uint64_t) i + 2};
+        shards[i].tree = i == 0 ? tree : splitRBTree(tree, &shards[i].lo);
+        CHECK(shards[i].tree != NULL);
+        for (int key = shards[i].lo; key < shards[i].hi; ++key)
+        {
+            shards[i].present[key] = (char) (RBTreeContains(shards[i].tree, &key) != 0);
+        }
+    }
+    for (int i = 0; i < SHARDS; ++i)
+    {
+        CHECK(pthread_create(&shards[i].thread, NULL, changeShard, &shards[i]) == 0);
+    }
+    for (int i = 0; i < SHARDS; ++i)
+    {
+        CHECK(pthread_join(shards[i].thread, NULL) == 0);
+        checkIntItems(shards[i].tree, shards[i].present, RANGE);
+    }
+    for (int i = 1; i < SHARDS; ++i)
+    {
+        CHECK(joinRBTree(tree, NULL, &shards[i].tree));
+        for (int key = shards[i].lo; key < shards[i].hi; ++key)
+        {
+            present[key] = shards[i].present[key];
+        }
+    }
+    checkIntItems(tree, present, RANGE);
+    freeRBTree(&tree);
+    free(present);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file splitJoinTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests splitRBTree and joinRBTree.
+ *
+ * @section DESCRIPTION
+ * Splits random trees at random keys and joins the parts back, with and without a pivot, and joins trees of very
+ * different sizes. Checks the red black rules, the sub-tree sizes and the items of every tree that is made, and that
+ * a split of a tree without order statistics and joins of items out of order or of trees that do not share nodes fail
+ * without changing the trees.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include <stdlib.h>
+#include <string.h>
+// -------------------------- const definitions -------------------------
+#define RANGE (4000)
+
+#define ROUNDS (200)
+
+#define MAX_JOINED (600)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief Inserts the keys from lo to hi - 1 that pass a random draw into a tree, and marks them.
+ */
+void fillRandomly(RBTree *tree, char *present, int lo, int hi, uint64_t *state)
+{
+    for (int key = lo; key < hi; ++key)
+    {
+        if (randomBelow(state, 2))
+        {
+            CHECK(insertToRBTree(tree, newInt(key)));
+            present[key] = 1;
+        }
+    }
+}
+
+/**
+ * @brief Splits a tree at random keys and joins the parts back.
+ * @param state The state of the random draws.
+ */
+void checkSplits(uint64_t *state)
+{
+    RBTreeOptions options = {.orderStatistics = 1, .poolSlabNodes = 64};
+    RBTree *tree = newRBTreeWithOptions(intCompare, free, &options);
+    char present[RANGE] = {0};
+    char lower[RANGE], upper[RANGE];
+    CHECK(tree != NULL);
+    fillRandomly(tree, present, 0, RANGE, state);
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        // keys a little outside the range split off all the items or none of them.
+        int key = randomBelow(state, RANGE + 2) - 1;
+        RBTree *greater = splitRBTree(tree, &key);
+        CHECK(greater != NULL);
+        for (int k = 0; k < RANGE; ++k)
+        {
+            lower[k] = (char) (present[k] && k < key);
+            upper[k] = (char) (present[k] && k >= key);
+        }
+        checkIntItems(tree, lower, RANGE);
+        checkIntItems(greater, upper, RANGE);
+        int *pivot = (int *) RBTreeSelect(greater, 0);
+        if (pivot != NULL && randomBelow(state, 2))
+        {
+            // joins around the smallest item of the greater tree, taken out of it.
+            int pivotKey = *pivot;
+            pivot = newInt(pivotKey);
+            CHECK(deleteFromRBTree(greater, &pivotKey));
+            CHECK(joinRBTree(tree, pivot, &greater));
+        }
+        else
+        {
+            CHECK(joinRBTree(tree, NULL, &greater));
+        }
+        CHECK(greater == NULL);
+        checkIntItems(tree, present, RANGE);
+    }
+    freeRBTree(&tree);
+}
+
+/**
+ * @brief Joins a tree of random size to trees of every other size, around a pivot.
+ * @param state The state of the random draws.
+ */
+void checkHeights(uint64_t *state)
+{
+    RBTreeOptions options = {.orderStatistics = 1};
+    RBTree *base = newRBTreeWithOptions(intCompare, free, &options);
+    CHECK(base != NULL);
+    for (int size = 0; size < MAX_JOINED; size += 7)
+    {
+        char present[2 * MAX_JOINED + 1] = {0};
+        int otherSize = randomBelow(state, MAX_JOINED);
+        int small = randomBelow(state, 2);
+        RBTree *tree = newRBTreeLike(base);
+        RBTree *other = newRBTreeLike(base);
+        CHECK(tree != NULL && other != NULL);
+        fillRandomly(tree, present, 0, small ? size : otherSize, state);
+        fillRandomly(other, present, MAX_JOINED + 1, MAX_JOINED + 1 + (small ? otherSize : size), state);
+        present[MAX_JOINED] = 1;
+        CHECK(joinRBTree(tree, newInt(MAX_JOINED), &other));
+        checkIntItems(tree, present, 2 * MAX_JOINED + 1);
+        freeRBTree(&tree);
+    }
+    freeRBTree(&base);
+}
+
+/**
+ * @brief Checks that bad splits and joins fail without changing the trees.
+ */
+void checkFailures(void)
+{
+    char present[RANGE] = {0};
+    char none[RANGE] = {0};
+    uint64_t state = 7;
+    RBTree *plain = newRBTree(intCompare, free);
+    CHECK(plain != NULL);
+    fillRandomly(plain, present, 0, RANGE / 2, &state);
+    int key = RANGE / 4;
+    CHECK(splitRBTree(plain, &key) == NULL);
+    checkIntItems(plain, present, RANGE);
+
+    RBTree *other = newRBTreeLike(plain);
+    CHECK(other != NULL);
+    CHECK(insertToRBTree(other, newInt(RANGE / 4)));
+    CHECK(!joinRBTree(plain, NULL, &other));
+    CHECK(other != NULL && other->size == 1);
+    checkIntItems(plain, present, RANGE);
+    deleteFromRBTree(other, &key);
+    int *pivot = newInt(0);
+    CHECK(!joinRBTree(plain, pivot, &other));
+    checkIntItems(plain, present, RANGE);
+    checkIntItems(other, none, RANGE);
+    free(pivot);
+
+    RBTreeOptions pooled = {.poolSlabNodes = 16};
+    RBTree *stranger = newRBTreeWithOptions(intCompare, free, &pooled);
+    CHECK(stranger != NULL);
+    CHECK(!joinRBTree(plain, NULL, &stranger));
+    CHECK(stranger != NULL);
+    checkIntItems(plain, present, RANGE);
+    freeRBTree(&stranger);
+    freeRBTree(&other);
+    freeRBTree(&plain);
+}
+
+int main(void)
+{
+    uint64_t state = 1;
+    checkSplits(&state);
+    checkHeights(&state);
+    checkFailures();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,195 @@
+/**
+ * @file stringArenaTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests StringArena and the string trees that keep their strings in one.
+ *
+ * @section DESCRIPTION
+ * Interns random strings, some of them longer than a block of the arena, and checks that equal strings share one
+ * copy and that the copies keep their text. Changes string trees made by newStringArenaRBTree, with and without a
+ * prefix, through copies of the strings the test then overwrites, and after every round checks the red black rules
+ * and compares the items in order with a sorted reference. Checks that a tree made like another one keeps its strings
+ * after the other is freed.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include "StringArena.h"
+#include "Structs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+// -------------------------- const definitions -------------------------
+#define NAMES (800)
+
+#define MAX_NAME_LENGTH (40)
+
+#define LONG_NAME_LENGTH (200000)
+
+#define ROUNDS (40)
+
+#define CHANGES_PER_ROUND (100)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief Compares two char * by strcmp, for qsort.
+ */
+int compareNames(const void *a, const void *b)
+{
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+/**
+ * @brief Makes NAMES different random strings, in ascending order. Some share a long prefix, so they compare past the
+ * prefix of the tree.
+ * @return The array of the strings.
+ */
+char **newSortedNames(uint64_t *state)
+{
+    char **names = (char **) malloc(NAMES * sizeof(char *));
+    CHECK(names != NULL);
+    for (int i = 0; i < NAMES; ++i)
+    {
+        names[i] = (char *) malloc(MAX_NAME_LENGTH + 1);
+        CHECK(names[i] != NULL);
+        int length = snprintf(names[i], MAX_NAME_LENGTH + 1, "%s%d-", i % 2 ? "shared-prefix-" : "", i);
+        int extra = randomBelow(state, MAX_NAME_LENGTH - length + 1);
+        for (int j = 0; j < extra; ++j)
+        {
+            names[i][length + j] = (char) ('a' + randomBelow(state, 26));
+        }
+        names[i][length + extra] = '\0';
+    }
+    qsort(names, NAMES, sizeof(char *), compareNames);
+    return names;
+}
+
+/**
+ * @brief Checks that a tree of strings holds exactly the marked names, in order, and all the invariants of the tree.
+ */
+void checkNames(const RBTree *tree, char *const *names, const char *present)
+{
+    checkRBTree(tree);
+    RBTreeIterator iter;
+    const char *item = (const char *) RBTreeFirst(tree, &iter);
+    for (int i = 0; i < NAMES; ++i)
+    {
+        if (present[i])
+        {
+            CHECK(item != NULL && strcmp(item, names[i]) == 0);
+            item = (const char *) RBTreeNext(&iter);
+        }
+    }
+    CHECK(item == NULL);
+}
+
+/**
+ * @brief Interns random strings and checks that equal strings share one copy that keeps their text.
+ */
+void checkArena(char *const *names, uint64_t *state)
+{
+    StringArena *arena = newStringArena();
+    const char *copies[NAMES] = {NULL};
+    char buffer[MAX_NAME_LENGTH + 1];
+    long unsigned distinct = 0;
+    CHECK(arena != NULL && stringArenaSize(arena) == 0);
+    for (int i = 0; i < 4 * NAMES; ++i)
+    {
+        int name = randomBelow(state, NAMES);
+        strcpy(buffer, names[name]);
+        const char *copy = internString(arena, buffer);
+        CHECK(copy != NULL && copy != buffer);
+        memset(buffer, '#', MAX_NAME_LENGTH);
+        distinct += copies[name] == NULL;
+        CHECK(copies[name] == NULL || copies[name] == copy);
+        copies[name] = copy;
+        CHECK(stringArenaSize(arena) == distinct);
+    }
+    for (int i = 0; i < NAMES; ++i)
+    {
+        CHECK(copies[i] == NULL || strcmp(copies[i], names[i]) == 0);
+    }
+
+    char *longName = (char *) malloc(LONG_NAME_LENGTH + 1);
+    CHECK(longName != NULL);
+    memset(longName, 'z', LONG_NAME_LENGTH);
+    longName[LONG_NAME_LENGTH] = '\0';
+    const char *longCopy = internString(arena, longName);
+    const char *empty = internString(arena, "");
+    CHECK(longCopy != NULL && strcmp(longCopy, longName) == 0 && internString(arena, longName) == longCopy);
+    CHECK(empty != NULL && *empty == '\0' && internString(arena, "") == empty);
+    CHECK(stringArenaSize(arena) == distinct + 2);
+    for (int i = 0; i < NAMES; ++i)
+    {
+        CHECK(copies[i] == NULL || strcmp(copies[i], names[i]) == 0);
+    }
+    free(longName);
+    freeStringArena(arena);
+    freeStringArena(NULL);
+}
+
+/**
+ * @brief Changes a string tree at random and compares it with the reference after every round.
+ * @param options The options of the tree.
+ */
+void checkTree(char *const *names, const RBTreeOptions *options, uint64_t *state)
+{
+    RBTree *tree = newStringArenaRBTree(options);
+    char present[NAMES] = {0};
+    char buffer[MAX_NAME_LENGTH + 1];
+    CHECK(tree != NULL && RBTreeResource(tree) != NULL);
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        int insertChance = round < ROUNDS / 2 ? 3 : 1;
+        for (int i = 0; i < CHANGES_PER_ROUND; ++i)
+        {
+            int name = randomBelow(state, NAMES);
+            strcpy(buffer, names[name]);
+            if (randomBelow(state, 4) < insertChance)
+            {
+                CHECK(insertStringToRBTree(tree, buffer) == !present[name]);
+                present[name] = 1;
+            }
+            else
+            {
+                CHECK(deleteFromRBTree(tree, buffer) == present[name]);
+                present[name] = 0;
+            }
+            memset(buffer, '#', MAX_NAME_LENGTH);
+        }
+        checkNames(tree, names, present);
+    }
+
+    RBTree *like = newRBTreeLike(tree);
+    char inLike[NAMES] = {0};
+    CHECK(like != NULL && RBTreeResource(like) == RBTreeResource(tree));
+    for (int i = 0; i < NAMES; i += 3)
+    {
+        CHECK(insertStringToRBTree(like, names[i]));
+        inLike[i] = 1;
+    }
+    freeRBTree(&tree);
+    checkNames(like, names, inLike);
+    freeRBTree(&like);
+}
+
+int main(void)
+{
+    uint64_t state = 1;
+    char **names = newSortedNames(&state);
+    for (int i = 1; i < NAMES; ++i)
+    {
+        CHECK(strcmp(names[i - 1], names[i]) < 0);
+    }
+    checkArena(names, &state);
+    RBTreeOptions plain = {0};
+    RBTreeOptions prefixed = {.prefixFunc = stringPrefix, .orderStatistics = 1, .poolSlabNodes = 64};
+    checkTree(names, &plain, &state);
+    checkTree(names, &prefixed, &state);
+    for (int i = 0; i < NAMES; ++i)
+    {
+        free(names[i]);
+    }
+    free(names);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file stringBuilderTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests StringBuilder, appendString and concatenateTree.
+ *
+ * @section DESCRIPTION
+ * Appends words to builders that start smaller than the result, and checks the text, the length and the growth of
+ * the buffer. Concatenates trees of words, empty ones included, and compares the result with the one of
+ * forEachRBTree and concatenate: the words are joined as they are, so a separator appears only where the words end
+ * with one, after every word and the last one included.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include "Structs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+// -------------------------- const definitions -------------------------
+#define WORDS (500)
+
+#define MAX_WORD_LENGTH (16)
+// ------------------------------ functions -----------------------------
+/**
+ * @param index A number.
+ * @param separator Appended to the word, "" for none.
+ * @return A new allocated word made of the number.
+ */
+static char *newWord(int index, const char *separator)
+{
+    char *word = (char *) malloc(MAX_WORD_LENGTH + 1);
+    CHECK(word != NULL);
+    snprintf(word, MAX_WORD_LENGTH + 1, "w%04d%s", index, separator);
+    return word;
+}
+
+/**
+ * @brief Appends words to builders with a room for nothing and for a little, and checks that they grow to hold all
+ * of them.
+ */
+static void checkBuilder(void)
+{
+    const size_t capacities[] = {0, 1, 7};
+    for (size_t c = 0; c < sizeof(capacities) / sizeof(capacities[0]); ++c)
+    {
+        StringBuilder builder;
+        char expected[WORDS * MAX_WORD_LENGTH + 1] = "";
+        size_t length = 0;
+        CHECK(initStringBuilder(&builder, capacities[c]));
+        CHECK(builder.length == 0 && builder.capacity == capacities[c] && builder.string[0] == '\0');
+        CHECK(appendString("", &builder) && builder.length == 0);
+        for (int i = 0; i < WORDS; ++i)
+        {
+            char *word = newWord(i, i % 2 ? ", " : "");
+            CHECK(appendString(word, &builder));
+            length += strlen(word);
+            strcat(expected, word);
+            free(word);
+            CHECK(builder.length == length && builder.capacity >= length);
+            CHECK(strlen(builder.string) == length);
+        }
+        CHECK(strcmp(builder.string, expected) == 0);
+        CHECK(builder.capacity > capacities[c]);
+        CHECK(!appendString(NULL, &builder));
+        CHECK(builder.length == length && strcmp(builder.string, expected) == 0);
+        freeStringBuilder(&builder);
+        CHECK(builder.string == NULL && builder.length == 0 && builder.capacity == 0);
+    }
+}
+
+/**
+ * @brief Concatenates a tree of words and compares the result with the one of concatenate.
+ * @param words The amount of words of the tree.
+ * @param separator Ends every word, "" for none.
+ */
+static void checkConcatenation(int words, const char *separator)
+{
+    RBTree *tree = newRBTree(stringCompare, freeString);
+    char expected[WORDS * MAX_WORD_LENGTH + 1] = "";
+    CHECK(tree != NULL);
+    // the words are inserted out of order, and concatenated in order.
+    for (int i = 0; i < words; ++i)
+    {
+        CHECK(insertToRBTree(tree, newWord((i * 7) % words, separator)));
+    }
+    CHECK(forEachRBTree(tree, concatenate, expected));
+    char *concatenated = concatenateTree(tree);
+    CHECK(concatenated != NULL && strcmp(concatenated, expected) == 0);
+    for (int i = 0; i < words; ++i)
+    {
+        char *word = newWord(i, separator);
+        size_t length = strlen(word);
+        CHECK(strncmp(concatenated + i * length, word, length) == 0);
+        free(word);
+    }
+    size_t separatorLength = strlen(separator);
+    size_t length = strlen(concatenated);
+    CHECK(words == 0 || separatorLength == 0 ||
+          strcmp(concatenated + length - separatorLength, separator) == 0);
+    freeString(concatenated);
+    freeRBTree(&tree);
+}
+
+int main(void)
+{
+    checkBuilder();
+    checkConcatenation(0, "");
+    checkConcatenation(0, "\n");
+    checkConcatenation(1, "\n");
+    checkConcatenation(WORDS, "");
+    checkConcatenation(WORDS, "\n");
+    return EXIT_SUCCESS;
+}
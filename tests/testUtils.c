@@ -0,0 +1,152 @@
+/**
+ * @file testUtils.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief The checks the tests share.
+ *
+ * @section DESCRIPTION
+ * Checks the red black rules, the links, the order, the size and the sub-tree sizes of a tree, and compares its items
+ * with a reference.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include "RBTreeInternal.h"
+#include <stdio.h>
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define NIL_HEIGHT (1)
+
+#define SEED (0x9E3779B97F4A7C15ull)
+// ------------------------------ functions -----------------------------
+/**
+ * @brief Fails the test with a message if a condition does not hold.
+ * @param holds Whether the condition holds.
+ * @param condition The text of the condition.
+ * @param file The file of the check.
+ * @param line The line of the check.
+ */
+void checkCondition(int holds, const char *condition, const char *file, int line)
+{
+    if (!holds)
+    {
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief CompareFunc for items of type int.
+ */
+int intCompare(const void *a, const void *b)
+{
+    int keyA = *(const int *) a;
+    int keyB = *(const int *) b;
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+/**
+ * @param value The value of the new item.
+ * @return A new allocated int item. The test fails if the allocation fails.
+ */
+int *newInt(int value)
+{
+    int *item = (int *) malloc(sizeof(int));
+    CHECK(item != NULL);
+    *item = value;
+    return item;
+}
+
+/**
+ * @param state The state of the generator, advanced by the call.
+ * @param bound The amount of possible numbers.
+ * @return A pseudo random number of a splitmix64 sequence, from 0 to bound - 1.
+ */
+int randomBelow(uint64_t *state, int bound)
+{
+    uint64_t z = (*state += SEED);
+    z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+    return (int) ((z ^ (z >> 31u)) % (uint64_t) bound);
+}
+
+/**
+ * @param node A node, may be NULL.
+ * @return Whether node is red (NULL is black).
+ */
+int isRed(const Node *node)
+{
+    return node != NULL && getColor(node) == RED;
+}
+
+/**
+ * @brief Checks the red black rules, the links and the sub-tree sizes of a sub-tree.
+ * @param tree The tree of the sub-tree.
+ * @param node The root of the sub-tree, may be NULL.
+ * @param parent The parent node must link to.
+ * @return The black height of the sub-tree.
+ */
+int checkSubtree(const RBTree *tree, const Node *node, const Node *parent)
+{
+    if (node == NULL)
+    {
+        return NIL_HEIGHT;
+    }
+    CHECK(getParent(node) == parent);
+    CHECK(!isRed(node) || (!isRed(node->left) && !isRed(node->right)));
+    int leftHeight = checkSubtree(tree, node->left, node);
+    int rightHeight = checkSubtree(tree, node->right, node);
+    CHECK(leftHeight == rightHeight);
+    if (tree->countOffset != 0)
+    {
+        CHECK(RBTreeSubtreeCount(tree, node) == RBTreeSubtreeCount(tree, node->left) + RBTreeSubtreeCount(tree, node->right) + 1);
+    }
+    return leftHeight + !isRed(node);
+}
+
+/**
+ * @brief Checks all the invariants of a tree.
+ * @param tree The tree to check.
+ * @return The black height of the tree.
+ */
+int checkRBTree(const RBTree *tree)
+{
+    CHECK(tree != NULL);
+    CHECK(!isRed(tree->root));
+    int height = checkSubtree(tree, tree->root, NULL);
+    RBTreeIterator iter;
+    long unsigned amount = 0;
+    const void *prev = NULL;
+    for (const void *item = RBTreeFirst(tree, &iter); item != NULL; item = RBTreeNext(&iter))
+    {
+        CHECK(prev == NULL || tree->compFunc(prev, item) < 0);
+        prev = item;
+        amount++;
+    }
+    CHECK(amount == tree->size);
+    CHECK(tree->countOffset == 0 || RBTreeSubtreeCount(tree, tree->root) == tree->size);
+    return height;
+}
+
+/**
+ * @brief Checks that the items of a tree of ints are exactly the marked numbers, and all the invariants of the tree.
+ * @param tree A tree of ints.
+ * @param present present[k] is not 0 if k must be in the tree.
+ * @param range The numbers from 0 to range - 1 are marked in present.
+ */
+void checkIntItems(const RBTree *tree, const char *present, int range)
+{
+    checkRBTree(tree);
+    RBTreeIterator iter;
+    const int *item = (const int *) RBTreeFirst(tree, &iter);
+    for (int k = 0; k < range; ++k)
+    {
+        if (present[k])
+        {
+            CHECK(item != NULL && *item == k);
+            item = (const int *) RBTreeNext(&iter);
+        }
+    }
+    CHECK(item == NULL);
+}
@@ -0,0 +1,61 @@
+#ifndef RBTREE_TESTUTILS_H
+#define RBTREE_TESTUTILS_H
+
+#include "RBTree.h"
+#include <stdint.h>
+
+/*
+ * the checks the tests share. a failed check prints where it failed and exits the test with a failure.
+ */
+
+/**
+ * checks a condition, and fails the test if it does not hold.
+ */
+#define CHECK(condition) checkCondition((condition) != 0, #condition, __FILE__, __LINE__)
+
+/**
+ * fails the test with a message if a condition does not hold.
+ * @param holds: whether the condition holds.
+ * @param condition: the text of the condition.
+ * @param file: the file of the check.
+ * @param line: the line of the check.
+ */
+void checkCondition(int holds, const char *condition, const char *file, int line);
+
+/**
+ * CompareFunc for items of type int.
+ */
+int intCompare(const void *a, const void *b);
+
+/**
+ * @param value: the value of the new item.
+ * @return: a new allocated int item. the test fails if the allocation fails.
+ */
+int *newInt(int value);
+
+/**
+ * @param state: the state of the generator, advanced by the call.
+ * @param bound: the amount of possible numbers.
+ * @return: a pseudo random number of a splitmix64 sequence, from 0 to bound - 1.
+ */
+int randomBelow(uint64_t *state, int bound);
+
+/**
+ * checks all the invariants of a tree: the root is black, no red node has a red child, every path from a node down
+ * to a leaf has the same amount of black nodes, every child links back to its parent, the items are strictly
+ * ascending, the size is the amount of items, and every node that keeps the size of its sub-tree keeps the right one.
+ * @param tree: the tree to check.
+ * @return: the black height of the tree.
+ */
+int checkRBTree(const RBTree *tree);
+
+/**
+ * checks that the items of a tree of ints are exactly the marked numbers, and all the invariants of the tree.
+ * @param tree: a tree of ints.
+ * @param present: present[k] is not 0 if k must be in the tree.
+ * @param range: the numbers from 0 to range - 1 are marked in present, the tree holds no other numbers.
+ */
+void checkIntItems(const RBTree *tree, const char *present, int range);
+
+
+#endif //RBTREE_TESTUTILS_H
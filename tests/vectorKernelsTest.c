@@ -0,0 +1,161 @@
+/**
+ * @file vectorKernelsTest.c
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ * @date 27 may 2020
+ *
+ * @brief Tests every version of the vector loops against the scalar one.
+ *
+ * @section DESCRIPTION
+ * Forces each version of the loops the processor supports through useVectorKernels, and compares sumOfSquares and
+ * firstDifference with the scalar version on vectors of every length up to two blocks of AVX-512 and one more, so
+ * every tail is taken. The coordinates are halves of small numbers, whose sums are exact in any order. Covers NaN
+ * coordinates, that neither differ nor are equal, and -0.0, that equals 0.0.
+ */
+// ------------------------------ includes ------------------------------
+#include "testUtils.h"
+#include "VectorKernels.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+// -------------------------- const definitions -------------------------
+#define MAX_LEN (17)
+
+#define KERNELS (3)
+// ------------------------------ functions -----------------------------
+/**
+ * @param len The amount of coordinates.
+ * @return A new vector of exactly len coordinates (so reading past them is caught by the sanitizers), with no
+ * coordinates for a len of 0.
+ */
+static double *newVector(int len)
+{
+    double *vector = (double *) malloc((len > 0 ? len : 1) * sizeof(double));
+    CHECK(vector != NULL);
+    for (int i = 0; i < len; ++i)
+    {
+        vector[i] = (i % 7 - 3) * 0.5;
+    }
+    return vector;
+}
+
+/**
+ * @param kernels A version of the loops, in use.
+ * @param coords The coordinates of a vector.
+ * @param len The amount of coordinates.
+ * @return The sum of the squares of the vector by the scalar version. kernels is used again on return.
+ */
+static double scalarSum(VectorKernels kernels, const double *coords, int len)
+{
+    CHECK(useVectorKernels(SCALAR_KERNELS));
+    double sum = sumOfSquares(coords, len);
+    CHECK(useVectorKernels(kernels));
+    return sum;
+}
+
+/**
+ * @param kernels A version of the loops, in use.
+ * @param a The coordinates of a vector.
+ * @param b The coordinates of another vector.
+ * @param len The amount of coordinates.
+ * @return The first difference of the vectors by the scalar version. kernels is used again on return.
+ */
+static int scalarDifference(VectorKernels kernels, const double *a, const double *b, int len)
+{
+    CHECK(useVectorKernels(SCALAR_KERNELS));
+    int index = firstDifference(a, b, len);
+    CHECK(useVectorKernels(kernels));
+    return index;
+}
+
+/**
+ * @brief Compares sumOfSquares of the version in use with the scalar one, on plain vectors, vectors with a NaN and
+ * vectors of zeros of both signs.
+ * @param kernels The version in use.
+ * @param len The amount of coordinates.
+ */
+static void checkSums(VectorKernels kernels, int len)
+{
+    double *coords = newVector(len);
+    double sum = sumOfSquares(coords, len);
+    CHECK(sum == scalarSum(kernels, coords, len));
+    for (int i = 0; i < len; ++i)
+    {
+        double saved = coords[i];
+        coords[i] = NAN;
+        CHECK(isnan(sumOfSquares(coords, len)) && isnan(scalarSum(kernels, coords, len)));
+        coords[i] = saved;
+    }
+    for (int i = 0; i < len; ++i)
+    {
+        coords[i] = i % 2 ? -0.0 : 0.0;
+    }
+    sum = sumOfSquares(coords, len);
+    CHECK(sum == 0.0 && !signbit(sum) && !signbit(scalarSum(kernels, coords, len)));
+    free(coords);
+}
+
+/**
+ * @brief Compares firstDifference of the version in use with the scalar one, for a difference at every index, with
+ * NaN coordinates and zeros of the other sign before it.
+ * @param kernels The version in use.
+ * @param len The amount of coordinates.
+ */
+static void checkDifferences(VectorKernels kernels, int len)
+{
+    double *a = newVector(len), *b = newVector(len);
+    CHECK(firstDifference(a, b, len) == len && scalarDifference(kernels, a, b, len) == len);
+    for (int at = 0; at < len; ++at)
+    {
+        b[at] += 1.0;
+        CHECK(firstDifference(a, b, len) == at && scalarDifference(kernels, a, b, len) == at);
+        b[at] -= 2.0;
+        CHECK(firstDifference(a, b, len) == at && scalarDifference(kernels, a, b, len) == at);
+        // NaN in one vector or in both, and zeros of the other sign, are no difference.
+        for (int i = 0; i < at; ++i)
+        {
+            switch (i % 3)
+            {
+                case 0:
+                    a[i] = NAN;
+                    break;
+                case 1:
+                    a[i] = b[i] = NAN;
+                    break;
+                default:
+                    a[i] = 0.0;
+                    b[i] = -0.0;
+            }
+        }
+        CHECK(firstDifference(a, b, len) == at && scalarDifference(kernels, a, b, len) == at);
+        // the coordinates after at are equal.
+        b[at] = NAN;
+        CHECK(firstDifference(a, b, len) == len && scalarDifference(kernels, a, b, len) == len);
+        free(a);
+        free(b);
+        a = newVector(len);
+        b = newVector(len);
+    }
+    free(a);
+    free(b);
+}
+
+int main(void)
+{
+    const VectorKernels kernels[KERNELS] = {SCALAR_KERNELS, AVX2_KERNELS, AVX512_KERNELS};
+    const char *names[KERNELS] = {"scalar", "AVX2", "AVX-512"};
+    for (int k = 0; k < KERNELS; ++k)
+    {
+        if (!useVectorKernels(kernels[k]))
+        {
+            printf("the %s kernels are not supported here, skipped\n", names[k]);
+            continue;
+        }
+        for (int len = 0; len <= MAX_LEN; ++len)
+        {
+            checkSums(kernels[k], len);
+            checkDifferences(kernels[k], len);
+        }
+    }
+    return EXIT_SUCCESS;
+}